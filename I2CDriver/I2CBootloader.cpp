@@ -0,0 +1,435 @@
+/* ----------------------------------------------------------------------------
+  I2CBootloader.cpp - Bootloader of a slave over the I2C bus
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include "I2CBootloader.hpp"
+
+#if BOOTLOADER_USAGE == USE_BOOTLOADER
+
+#if I2C_MODE == MODE_SLAVE
+#include <avr/boot.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+#if I2C_BOOT_PAGE_SIZE != SPM_PAGESIZE
+#error I2C_BOOT_PAGE_SIZE must be the flash page size SPM_PAGESIZE
+#endif
+#endif
+
+/** Number of polls of a busy slave before it is considered absent */
+#define MAX_BUSY_POLLING				10000
+
+#if I2C_MODE == MODE_SLAVE
+/**
+ * Definition of a page buffer
+ */
+typedef struct {
+	/* Byte address of the page */
+	uint16_t address;
+	/* Number of bytes received, up to 256 */
+	uint16_t filled;
+	/* Set when the page is complete and waits its write */
+	volatile uint8_t ready;
+	uint8_t data[I2C_BOOT_PAGE_SIZE];
+} tBootPage;
+
+/**
+ * Definition of the state of the flash
+ */
+typedef enum {
+	FLASH_IDLE,
+	FLASH_ERASING,
+	FLASH_WRITING
+} tFlashState;
+
+/** Page buffers */
+static tBootPage bootPages[2];
+
+/** Buffer receiving the page */
+static uint8_t receivePage;
+
+/** Buffer of the next page to write */
+static uint8_t programPage;
+
+/** Step of the write of the page */
+static tFlashState flashState;
+
+/** Status read by the master */
+static tI2CBootStatus bootStatus;
+
+/** VERIFY received, length and CRC */
+static volatile uint8_t verifyRequested;
+static uint16_t verifyLength;
+static uint16_t verifyCrc;
+
+/** START_APPLICATION received */
+static volatile uint8_t startRequested;
+
+/** Error of the state read by a VERIFY, cleared by the next page */
+static volatile uint8_t errorReported;
+#endif
+
+/** Instantiation of the bootloader */
+I2CBootloader i2cBootloader;
+
+/**
+ * CRC-16 CCITT (polynomial 0x1021) of data.
+ *
+ * crc      : CRC of the previous data, 0xFFFF for the first data
+ * data     : data
+ * length   : number of bytes
+ * return   : CRC with the data
+ */
+uint16_t I2CBootloader::updateCrc(uint16_t crc, const uint8_t *data, uint16_t length) {
+	uint8_t bit;
+
+	while (length--) {
+		crc ^= (uint16_t) *data++ << 8;
+		for (bit = 0; bit < 8; bit++) {
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+#if I2C_MODE == MODE_MASTER
+/*
+ * Function waitDriverReady
+ * Desc     wait the end of the current request
+ * Input    none
+ * Output   none
+ */
+static void waitDriverReady(void) {
+	while (!i2cDriver.isReady())
+		;
+}
+
+/*
+ * Function sendFrame
+ * Desc     send a frame, poll the slave while it does not acknowledge
+ * Input    address : address of the slave
+ *          frame   : frame
+ *          length  : size of the frame
+ * Output   status of the frame
+ */
+static tI2CDriverError sendFrame(uint8_t address, uint8_t *frame, uint8_t length) {
+	uint16_t polling;
+
+	for (polling = 0; polling < MAX_BUSY_POLLING; polling++) {
+		waitDriverReady();
+		i2cDriver.sendTo(address, frame, length);
+		waitDriverReady();
+		if (i2cDriver.getLastStatus() != I2C_MISSING_ACK) {
+			break;
+		}
+	}
+	return i2cDriver.getLastStatus();
+}
+
+/**
+ * Send a page of the image to a slave.
+ * The page is sent in frames of I2C_BOOT_CHUNK_SIZE bytes. The function
+ * returns when the page is received, not when it is written: the slave
+ * writes it while the next page is sent.
+ *
+ * address     : address of the slave
+ * pageAddress : byte address of the page in the flash of the slave
+ * data        : I2C_BOOT_PAGE_SIZE bytes of the page
+ * return      : status of the frames
+ */
+tI2CDriverError I2CBootloader::sendPage(uint8_t address, uint16_t pageAddress, const uint8_t *data) {
+	uint8_t frame[4 + I2C_BOOT_CHUNK_SIZE];
+	uint16_t offset;
+	tI2CDriverError status = I2C_OK;
+
+	for (offset = 0; offset < I2C_BOOT_PAGE_SIZE && status == I2C_OK; offset += I2C_BOOT_CHUNK_SIZE) {
+		uint8_t length = I2C_BOOT_PAGE_SIZE - offset < I2C_BOOT_CHUNK_SIZE ?
+				I2C_BOOT_PAGE_SIZE - offset : I2C_BOOT_CHUNK_SIZE;
+		uint8_t i;
+
+		frame[0] = BOOT_COMMAND_PAGE_DATA;
+		frame[1] = pageAddress & 0xFF;
+		frame[2] = pageAddress >> 8;
+		frame[3] = offset;
+		for (i = 0; i < length; i++) {
+			frame[4 + i] = data[offset + i];
+		}
+		status = sendFrame(address, frame, 4 + length);
+	}
+	return status;
+}
+
+/**
+ * Compare the CRC of the flash of a slave.
+ * The slave computes the CRC once the received pages are written, it does
+ * not acknowledge its address until the end of the computation.
+ *
+ * address  : address of the slave
+ * length   : number of bytes of the image, from the address 0
+ * crc      : CRC of the image, see updateCrc
+ * status   : status of the slave, state BOOT_VERIFY_OK if the CRC are the same
+ * return   : status of the frames
+ */
+tI2CDriverError I2CBootloader::verify(uint8_t address, uint16_t length, uint16_t crc, tI2CBootStatus *status) {
+	uint8_t frame[5];
+	uint16_t polling;
+
+	frame[0] = BOOT_COMMAND_VERIFY;
+	frame[1] = length & 0xFF;
+	frame[2] = length >> 8;
+	frame[3] = crc & 0xFF;
+	frame[4] = crc >> 8;
+	if (sendFrame(address, frame, sizeof(frame)) != I2C_OK) {
+		return i2cDriver.getLastStatus();
+	}
+
+	for (polling = 0; polling < MAX_BUSY_POLLING; polling++) {
+		waitDriverReady();
+		i2cDriver.readFrom(address, (uint8_t*) status, sizeof(tI2CBootStatus));
+		waitDriverReady();
+		if (i2cDriver.getLastStatus() != I2C_MISSING_ACK) {
+			break;
+		}
+	}
+	return i2cDriver.getLastStatus();
+}
+
+/**
+ * Start the application of a slave.
+ *
+ * address  : address of the slave
+ * return   : status of the frame
+ */
+tI2CDriverError I2CBootloader::startApplication(uint8_t address) {
+	uint8_t command = BOOT_COMMAND_START_APPLICATION;
+
+	return sendFrame(address, &command, 1);
+}
+#endif
+
+#if I2C_MODE == MODE_SLAVE
+/*
+ * Function receivePageData
+ * Desc     store the bytes of a PAGE_DATA frame, called in the interruption
+ * Input    buffer : received frame
+ *          size   : size of the frame
+ * Output   none
+ */
+static void receivePageData(uint8_t *buffer, uint8_t size) {
+	tBootPage *page = &bootPages[receivePage];
+	uint16_t address = buffer[1] | (buffer[2] << 8);
+	uint8_t offset = buffer[3];
+	uint8_t length = size - 4;
+	uint8_t i;
+
+	if (errorReported && offset == 0) {
+		// The master sends the image again after the VERIFY reporting the error
+		bootStatus.state = BOOT_READY;
+		errorReported = 0;
+	}
+
+	if (address % I2C_BOOT_PAGE_SIZE != 0 || address >= I2C_BOOT_SECTION_START) {
+		bootStatus.state = BOOT_ADDRESS_ERROR;
+		return;
+	}
+
+	if (page->ready) {
+		bootStatus.state = BOOT_SEQUENCE_ERROR;
+		return;
+	}
+
+	if (offset == 0) {
+		page->address = address;
+		page->filled = 0;
+	}
+	if (offset != page->filled || address != page->address || length > I2C_BOOT_PAGE_SIZE - offset) {
+		bootStatus.state = BOOT_SEQUENCE_ERROR;
+		page->filled = 0;
+		return;
+	}
+
+	for (i = 0; i < length; i++) {
+		page->data[offset + i] = buffer[4 + i];
+	}
+	page->filled += length;
+
+	if (page->filled == I2C_BOOT_PAGE_SIZE) {
+		page->ready = 1;
+		receivePage ^= 1;
+		// No free buffer until the end of the write of the previous page
+		if (bootPages[receivePage].ready) {
+			i2cDriver.setSlaveBusy(1);
+		}
+	}
+}
+
+/*
+ * Function bootReceive
+ * Desc     reception callback of the driver
+ * Input    buffer : received frame
+ *          size   : size of the frame
+ * Output   none
+ */
+static void bootReceive(uint8_t *buffer, uint8_t size) {
+	if (size == 0) {
+		return;
+	}
+
+	switch (buffer[0]) {
+	case BOOT_COMMAND_PAGE_DATA:
+		if (size > 4) {
+			receivePageData(buffer, size);
+		}
+		break;
+
+	case BOOT_COMMAND_VERIFY:
+		if (size >= 5) {
+			verifyLength = buffer[1] | (buffer[2] << 8);
+			verifyCrc = buffer[3] | (buffer[4] << 8);
+			verifyRequested = 1;
+			// The status is read once the CRC is computed
+			i2cDriver.setSlaveBusy(1);
+		}
+		break;
+
+	case BOOT_COMMAND_START_APPLICATION:
+		startRequested = 1;
+		break;
+	}
+}
+
+/*
+ * Function bootTransmit
+ * Desc     transmission callback of the driver
+ * Input    none
+ * Output   status of the bootloader
+ */
+static uint8_t* bootTransmit(void) {
+	return (uint8_t*) &bootStatus;
+}
+
+/**
+ * Initialization of the bootloader.
+ * The interruption vectors are moved to the boot section, the application
+ * section is written by the bootloader.
+ */
+void I2CBootloader::initialisation(void) {
+	cli();
+	MCUCR = _BV(IVCE);
+	MCUCR = _BV(IVSEL);
+
+	bootStatus.state = BOOT_READY;
+	i2cDriver.setSlaveReceivedCallback(bootReceive);
+	i2cDriver.setSlaveTransmitCallback(bootTransmit, sizeof(tI2CBootStatus));
+	i2cDriver.initialisation();
+	sei();
+}
+
+/**
+ * Write the received pages in the flash. The erase and the write of a page
+ * run in the background (the bootloader runs from the NRWW section), each
+ * call starts the next step when the SPM is not busy.
+ */
+void I2CBootloader::process(void) {
+	tBootPage *page = &bootPages[programPage];
+	uint16_t i;
+
+	if (boot_spm_busy()) {
+		return;
+	}
+
+	switch (flashState) {
+	case FLASH_IDLE:
+		if (page->ready) {
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+				boot_page_erase(page->address);
+			}
+			flashState = FLASH_ERASING;
+		} else if (verifyRequested) {
+			uint16_t crc = 0xFFFF;
+
+			for (i = 0; i < verifyLength; i++) {
+				uint8_t value = pgm_read_byte(i);
+
+				crc = updateCrc(crc, &value, 1);
+			}
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+				bootStatus.crc = crc;
+				if (bootStatus.state != BOOT_ADDRESS_ERROR && bootStatus.state != BOOT_SEQUENCE_ERROR) {
+					bootStatus.state = crc == verifyCrc ? BOOT_VERIFY_OK : BOOT_VERIFY_ERROR;
+				} else {
+					errorReported = 1;
+				}
+				verifyRequested = 0;
+			}
+			i2cDriver.setSlaveBusy(0);
+		} else if (startRequested) {
+			runApplication();
+		}
+		break;
+
+	case FLASH_ERASING:
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			for (i = 0; i < I2C_BOOT_PAGE_SIZE; i += 2) {
+				boot_page_fill(page->address + i, page->data[i] | (page->data[i + 1] << 8));
+			}
+			boot_page_write(page->address);
+		}
+		flashState = FLASH_WRITING;
+		break;
+
+	case FLASH_WRITING:
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			boot_rww_enable();
+			page->ready = 0;
+			bootStatus.pagesWritten++;
+		}
+		programPage ^= 1;
+		flashState = FLASH_IDLE;
+		if (!verifyRequested) {
+			i2cDriver.setSlaveBusy(0);
+		}
+		break;
+	}
+}
+
+/**
+ * Leave the bootloader and start the application at the address 0.
+ */
+void I2CBootloader::runApplication(void) {
+	boot_spm_busy_wait();
+	boot_rww_enable();
+	i2cDriver.disable();
+
+	cli();
+	MCUCR = _BV(IVCE);
+	MCUCR = 0;
+	((void (*)(void)) 0)();
+}
+#endif
+
+#endif
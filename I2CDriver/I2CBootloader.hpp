@@ -0,0 +1,137 @@
+/* ----------------------------------------------------------------------------
+  I2CBootloader.hpp - Bootloader of a slave over the I2C bus
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CBOOTLOADER_HPP_
+#define I2CBOOTLOADER_HPP_
+
+#include "I2CDriver.hpp"
+
+#if BOOTLOADER_USAGE == USE_BOOTLOADER
+
+/** Check consistency of the bootloader configuration */
+#ifndef I2C_BOOT_PAGE_SIZE
+#error I2C_BOOT_PAGE_SIZE must be defined
+#elif I2C_BOOT_PAGE_SIZE < 32 || I2C_BOOT_PAGE_SIZE > 256
+#error I2C_BOOT_PAGE_SIZE must be defined with a value between 32 and 256
+#endif
+#ifndef I2C_BOOT_CHUNK_SIZE
+#error I2C_BOOT_CHUNK_SIZE must be defined
+#elif I2C_BOOT_CHUNK_SIZE < 1 || I2C_BOOT_CHUNK_SIZE > I2C_BOOT_PAGE_SIZE
+#error I2C_BOOT_CHUNK_SIZE must be defined with a value between 1 and I2C_BOOT_PAGE_SIZE
+#endif
+#if I2C_MODE == MODE_SLAVE
+#if I2C_BOOT_CHUNK_SIZE + 4 > I2C_BUFFER_SIZE
+#error I2C_BUFFER_SIZE is too small for the frames of the bootloader
+#endif
+#ifndef I2C_BOOT_SECTION_START
+#error I2C_BOOT_SECTION_START must be defined
+#endif
+#endif
+
+/**
+ * Definition of the frames of the bootloader
+ *
+ * PAGE_DATA         : [cmd, page address (2 bytes), offset, data] bytes of a
+ *                     page from an offset, the page is written when complete
+ * VERIFY            : [cmd, length (2 bytes), crc (2 bytes)] compare the CRC
+ *                     of the flash from the address 0 with the CRC
+ * START_APPLICATION : [cmd] leave the bootloader
+ * The words are little endian.
+ */
+typedef enum {
+	BOOT_COMMAND_PAGE_DATA = 0x01,
+	BOOT_COMMAND_VERIFY = 0x02,
+	BOOT_COMMAND_START_APPLICATION = 0x03
+} tI2CBootCommand;
+
+/**
+ * Definition of the state of the bootloader
+ *
+ * BOOT_ADDRESS_ERROR and BOOT_SEQUENCE_ERROR are kept until a VERIFY reports
+ * them, the rejected frame is dropped. After this VERIFY, the next PAGE_DATA
+ * frame at the offset 0 sets the state back to BOOT_READY: the master sends
+ * the image again from its first page, then verifies it.
+ */
+typedef enum {
+	BOOT_READY,
+	BOOT_ADDRESS_ERROR,
+	BOOT_SEQUENCE_ERROR,
+	BOOT_VERIFY_OK,
+	BOOT_VERIFY_ERROR
+} tI2CBootState;
+
+/**
+ * Definition of the status read from the bootloader, sent in this order
+ */
+typedef struct {
+	/* Number of pages written */
+	uint16_t pagesWritten;
+	/* CRC of the flash computed by the last VERIFY */
+	uint16_t crc;
+	/* State, tI2CBootState */
+	uint8_t state;
+} tI2CBootStatus;
+
+/**
+ * Bootloader over the I2C bus.
+ *
+ * The slave receives the pages in two RAM buffers: a page is received
+ * while the previous one is written in the flash. When both buffers are
+ * full, the slave does not acknowledge its address and the master polls it.
+ */
+class I2CBootloader {
+
+public:
+
+	/* CRC-16 CCITT of data, start with 0xFFFF */
+	static uint16_t updateCrc(uint16_t crc, const uint8_t* data, uint16_t length);
+
+#if I2C_MODE == MODE_MASTER
+	/* Send a page of the image to a slave, wait the end of the frames */
+	tI2CDriverError sendPage(uint8_t address, uint16_t pageAddress, const uint8_t* data);
+	/* Compare the CRC of the flash of a slave, wait the result */
+	tI2CDriverError verify(uint8_t address, uint16_t length, uint16_t crc, tI2CBootStatus* status);
+	/* Start the application of a slave */
+	tI2CDriverError startApplication(uint8_t address);
+#endif
+
+#if I2C_MODE == MODE_SLAVE
+	/* Initialization of the bootloader and of the I2C driver */
+	void initialisation(void);
+	/* Write the received pages in the flash, must be called in the main loop */
+	void process(void);
+	/* Leave the bootloader and start the application */
+	void runApplication(void);
+#endif
+};
+
+/** Instantiation of the bootloader */
+extern I2CBootloader i2cBootloader;
+
+#endif
+
+#endif /* I2CBOOTLOADER_HPP_ */
@@ -0,0 +1,494 @@
+/* ----------------------------------------------------------------------------
+  I2CBridge.cpp - Bridge of a slave to a downstream I2C bus
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include "I2CBridge.hpp"
+
+#if BRIDGE_USAGE == USE_BRIDGE
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include <util/delay.h>
+
+/** Hold the upstream event: the interruption is disabled and TWINT stays set, SCL is stretched */
+#define HOLD_UPSTREAM()					TWCR = _BV(TWEN)
+
+/** Release the upstream event, the next byte is acknowledged or not */
+#define RELEASE_UPSTREAM(ack)			TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT) | ((ack) ? _BV(TWEA) : 0)
+
+/** Open drain outputs of the downstream bus, the PORT bits stay at 0 */
+#define SDA_LOW()						I2C_BRIDGE_DDR |= _BV(I2C_BRIDGE_SDA)
+#define SDA_RELEASE()					I2C_BRIDGE_DDR &= ~_BV(I2C_BRIDGE_SDA)
+#define SCL_LOW()						I2C_BRIDGE_DDR |= _BV(I2C_BRIDGE_SCL)
+#define SDA_READ()						(I2C_BRIDGE_PIN & _BV(I2C_BRIDGE_SDA))
+#define SCL_READ()						(I2C_BRIDGE_PIN & _BV(I2C_BRIDGE_SCL))
+#define HALF_BIT()						_delay_us(I2C_BRIDGE_HALF_BIT_US)
+
+/** Number of half bits a downstream device may stretch the clock */
+#define MAX_STRETCH_HALF_BITS			1000
+
+/**
+ * Definition of a static register
+ */
+typedef struct {
+	/* Address of the device, 0 if the entry is free */
+	uint8_t address;
+	uint8_t reg;
+	/* Number of bytes cached */
+	uint8_t length;
+	/* Set when the bytes have been read from the device */
+	uint8_t valid;
+	uint8_t data[I2C_BRIDGE_CACHE_SIZE];
+} tBridgeCacheEntry;
+
+/** Static registers */
+static tBridgeCacheEntry cacheEntries[I2C_BRIDGE_CACHE_ENTRIES];
+
+/** Set when the current upstream frame is forwarded */
+static uint8_t bridged;
+
+/** Downstream address of the current frame */
+static uint8_t bridgedAddress;
+
+/** Held upstream event, its status and its data */
+static volatile uint8_t eventPending;
+static uint8_t eventStatus;
+static uint8_t eventData;
+
+/** Number of bytes of the current frame */
+static uint8_t frameLength;
+
+/** Register pointer written by the last frame of one byte and its device, 0 if unknown */
+static uint8_t pointerAddress;
+static uint8_t pointerRegister;
+
+/** Entry of the cache answering or filled by the current read, 0 if none */
+static tBridgeCacheEntry *readEntry;
+
+/** Set when the current read is answered from the cache */
+static uint8_t readFromCache;
+
+/** Set when the downstream device has not acknowledged the current frame */
+static uint8_t downstreamNack;
+
+/** Number of downstream frames not acknowledged */
+static uint16_t downstreamNacks;
+
+/* Instantiation of the bridge */
+I2CBridge i2cBridge;
+
+/*
+ * Function sclRelease
+ * Desc     release SCL and wait the end of the clock stretching
+ * Input    none
+ * Output   0 if SCL is held low too long
+ */
+static uint8_t sclRelease(void) {
+	uint16_t halfBits;
+
+	I2C_BRIDGE_DDR &= ~_BV(I2C_BRIDGE_SCL);
+	for (halfBits = 0; !SCL_READ(); halfBits++) {
+		if (halfBits == MAX_STRETCH_HALF_BITS) {
+			return 0;
+		}
+		HALF_BIT();
+	}
+	return 1;
+}
+
+/*
+ * Function downstreamStart
+ * Desc     start condition on the downstream bus, SCL is left low
+ * Input    none
+ * Output   none
+ */
+static void downstreamStart(void) {
+	SDA_RELEASE();
+	sclRelease();
+	HALF_BIT();
+	SDA_LOW();
+	HALF_BIT();
+	SCL_LOW();
+}
+
+/*
+ * Function downstreamStop
+ * Desc     stop condition on the downstream bus
+ * Input    none
+ * Output   none
+ */
+static void downstreamStop(void) {
+	SDA_LOW();
+	HALF_BIT();
+	sclRelease();
+	HALF_BIT();
+	SDA_RELEASE();
+	HALF_BIT();
+}
+
+/*
+ * Function downstreamBit
+ * Desc     transfer a bit, SCL is left low
+ * Input    value : bit sent, 1 to read the bit of the device
+ * Output   value of SDA at the rising edge of SCL
+ */
+static uint8_t downstreamBit(uint8_t value) {
+	uint8_t sda;
+
+	if (value) {
+		SDA_RELEASE();
+	} else {
+		SDA_LOW();
+	}
+	HALF_BIT();
+	if (!sclRelease()) {
+		return 1;
+	}
+	HALF_BIT();
+	sda = SDA_READ() != 0;
+	SCL_LOW();
+	return sda;
+}
+
+/*
+ * Function downstreamWrite
+ * Desc     send a byte
+ * Input    value : byte to send
+ * Output   1 if the device has acknowledged the byte
+ */
+static uint8_t downstreamWrite(uint8_t value) {
+	uint8_t i;
+
+	for (i = 0; i < 8; i++) {
+		downstreamBit(value & 0x80);
+		value <<= 1;
+	}
+	return !downstreamBit(1);
+}
+
+/*
+ * Function downstreamRead
+ * Desc     receive a byte, the acknowledge is sent by downstreamBit
+ * Input    none
+ * Output   received byte
+ */
+static uint8_t downstreamRead(void) {
+	uint8_t value = 0;
+	uint8_t i;
+
+	for (i = 0; i < 8; i++) {
+		value = (value << 1) | downstreamBit(1);
+	}
+	return value;
+}
+
+/*
+ * Function findEntry
+ * Desc     find the static register of a device
+ * Input    address : address of the device
+ *          reg     : register
+ * Output   entry of the register, 0 if the register is not static
+ */
+static tBridgeCacheEntry* findEntry(uint8_t address, uint8_t reg) {
+	uint8_t i;
+
+	for (i = 0; i < I2C_BRIDGE_CACHE_ENTRIES; i++) {
+		if (cacheEntries[i].address == address && cacheEntries[i].reg == reg) {
+			return &cacheEntries[i];
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function cacheTransmit
+ * Desc     send the next cached byte to the upstream master
+ * Input    none
+ * Output   none
+ */
+static void cacheTransmit(void) {
+	if (frameLength < readEntry->length) {
+		TWDR = readEntry->data[frameLength++];
+	} else {
+		TWDR = 0xFF;
+	}
+	RELEASE_UPSTREAM(frameLength < readEntry->length);
+}
+
+/**
+ * Initialization of the downstream bus and of the address mask.
+ * The I2C driver must be initialized in slave mode.
+ */
+void I2CBridge::initialisation(void) {
+	I2C_BRIDGE_PORT &= ~(_BV(I2C_BRIDGE_SDA) | _BV(I2C_BRIDGE_SCL));
+	I2C_BRIDGE_DDR &= ~(_BV(I2C_BRIDGE_SDA) | _BV(I2C_BRIDGE_SCL));
+	invalidateCache();
+	bridged = 0;
+	eventPending = 0;
+	TWAMR = I2C_BRIDGE_ADDRESS_MASK << 1;
+}
+
+/**
+ * Handle an event of the TWI in the interruption.
+ * The events of the frames of the slave are handled by the driver. The
+ * reads of a cached register are answered at once, the other events of
+ * the forwarded frames are held until process.
+ *
+ * status   : status of the TWI
+ * return   : 0 if the event is handled by the driver
+ */
+uint8_t I2CBridge::interrupt(uint8_t status) {
+	switch (status) {
+	case SR_START_TRANSMISSION_RECEIVED_60:
+	case SR_ARBITRATION_LOST_ACK_RETURN_68:
+	case ST_START_TRANSMISSION_RECEIVED_A8:
+	case ST_ARBITRATION_LOST_ACK_RETURN_B0:
+		// TWDR holds the received address
+		bridged = (TWDR >> 1) != (TWAR >> 1);
+		if (!bridged) {
+			return 0;
+		}
+		bridgedAddress = TWDR >> 1;
+		frameLength = 0;
+		readFromCache = 0;
+		readEntry = 0;
+		if (status == ST_START_TRANSMISSION_RECEIVED_A8 || status == ST_ARBITRATION_LOST_ACK_RETURN_B0) {
+			if (pointerAddress == bridgedAddress) {
+				readEntry = findEntry(bridgedAddress, pointerRegister);
+			}
+			if (readEntry != 0 && readEntry->valid) {
+				readFromCache = 1;
+				cacheTransmit();
+				return 1;
+			}
+		}
+		break;
+
+	case ST_DATA_TRANSMIT_ACK_RECEIVED_B8:
+		if (!bridged) {
+			return 0;
+		}
+		if (readFromCache) {
+			cacheTransmit();
+			return 1;
+		}
+		break;
+
+	case ST_DATA_TRANSMIT_NO_ACK_RECEIVED_C0:
+	case ST_LAST_DATA_TRANSMIT_ACK_RECEIVED_C8:
+		if (!bridged) {
+			return 0;
+		}
+		if (readFromCache) {
+			pointerAddress = 0;
+			bridged = 0;
+			RELEASE_UPSTREAM(1);
+			return 1;
+		}
+		break;
+
+	case SR_DATA_RECEIVED_ACK_RETURN_80:
+	case SR_DATA_RECEIVED_NO_ACK_RETURN_88:
+	case SR_STOP_RECEIVED:
+		if (!bridged) {
+			return 0;
+		}
+		break;
+
+	default:
+		// General calls and errors are handled by the driver
+		if (bridged) {
+			bridged = 0;
+			eventStatus = COMMON_BUS_EEOR_00;
+			eventPending = 1;
+		}
+		return 0;
+	}
+
+	eventStatus = status;
+	eventData = TWDR;
+	eventPending = 1;
+	HOLD_UPSTREAM();
+	return 1;
+}
+
+/**
+ * Forward the held event to the downstream bus, then release the upstream
+ * bus. The ACK of a written byte by the device is given to the master with
+ * the next byte.
+ */
+void I2CBridge::process(void) {
+	uint8_t value;
+
+	if (!eventPending) {
+		return;
+	}
+
+	switch (eventStatus) {
+	case SR_START_TRANSMISSION_RECEIVED_60:
+	case SR_ARBITRATION_LOST_ACK_RETURN_68:
+		downstreamStart();
+		downstreamNack = !downstreamWrite(bridgedAddress << 1);
+		if (downstreamNack) {
+			downstreamNacks++;
+		}
+		eventPending = 0;
+		RELEASE_UPSTREAM(!downstreamNack);
+		break;
+
+	case SR_DATA_RECEIVED_ACK_RETURN_80:
+		if (frameLength++ == 0) {
+			pointerAddress = bridgedAddress;
+			pointerRegister = eventData;
+		}
+		if (!downstreamNack && !downstreamWrite(eventData)) {
+			downstreamNack = 1;
+			downstreamNacks++;
+		}
+		eventPending = 0;
+		RELEASE_UPSTREAM(!downstreamNack);
+		break;
+
+	case SR_DATA_RECEIVED_NO_ACK_RETURN_88:
+		// Byte refused after a NACK of the device, the TWI is no more addressed
+		downstreamStop();
+		pointerAddress = 0;
+		bridged = 0;
+		eventPending = 0;
+		RELEASE_UPSTREAM(1);
+		break;
+
+	case SR_STOP_RECEIVED:
+		// A repeated start is forwarded as a stop followed by a start
+		downstreamStop();
+		if (frameLength != 1) {
+			pointerAddress = 0;
+		}
+		bridged = 0;
+		eventPending = 0;
+		RELEASE_UPSTREAM(1);
+		break;
+
+	case ST_START_TRANSMISSION_RECEIVED_A8:
+	case ST_ARBITRATION_LOST_ACK_RETURN_B0:
+		downstreamStart();
+		downstreamNack = !downstreamWrite((bridgedAddress << 1) | 1);
+		if (downstreamNack) {
+			// The address is already acknowledged upstream, the master gets 0xFF
+			downstreamNacks++;
+			downstreamStop();
+			TWDR = 0xFF;
+			eventPending = 0;
+			RELEASE_UPSTREAM(0);
+			break;
+		}
+		/* falls through */
+	case ST_DATA_TRANSMIT_ACK_RECEIVED_B8:
+		if (eventStatus == ST_DATA_TRANSMIT_ACK_RECEIVED_B8) {
+			// The master wants the next byte
+			downstreamBit(0);
+		}
+		value = downstreamRead();
+		if (readEntry != 0 && frameLength < readEntry->length) {
+			readEntry->data[frameLength] = value;
+			readEntry->valid = frameLength + 1 == readEntry->length;
+		}
+		frameLength++;
+		TWDR = value;
+		eventPending = 0;
+		RELEASE_UPSTREAM(1);
+		break;
+
+	case ST_DATA_TRANSMIT_NO_ACK_RECEIVED_C0:
+	case ST_LAST_DATA_TRANSMIT_ACK_RECEIVED_C8:
+		if (!downstreamNack) {
+			downstreamBit(1);
+			downstreamStop();
+		}
+		// The read has moved the register pointer of the device
+		pointerAddress = 0;
+		bridged = 0;
+		eventPending = 0;
+		RELEASE_UPSTREAM(1);
+		break;
+
+	default:
+		// Upstream bus error, the driver has released the upstream bus
+		downstreamStop();
+		eventPending = 0;
+		break;
+	}
+}
+
+/**
+ * Cache the reads of a register which never changes (identifier,
+ * calibration). The first read of length bytes or more from the register
+ * is forwarded and stored, the next reads following a write of the
+ * register pointer are answered without stretching the clock.
+ *
+ * address  : address of the downstream device
+ * reg      : register
+ * length   : number of bytes cached, at most I2C_BRIDGE_CACHE_SIZE
+ * return   : 0 if the cache is full
+ */
+uint8_t I2CBridge::setStaticRegister(uint8_t address, uint8_t reg, uint8_t length) {
+	uint8_t i;
+
+	for (i = 0; i < I2C_BRIDGE_CACHE_ENTRIES; i++) {
+		if (cacheEntries[i].address == 0) {
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+				cacheEntries[i].reg = reg;
+				cacheEntries[i].length = length < I2C_BRIDGE_CACHE_SIZE ? length : I2C_BRIDGE_CACHE_SIZE;
+				cacheEntries[i].valid = 0;
+				cacheEntries[i].address = address;
+			}
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Forget the cached values, the static registers are kept.
+ */
+void I2CBridge::invalidateCache(void) {
+	uint8_t i;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for (i = 0; i < I2C_BRIDGE_CACHE_ENTRIES; i++) {
+			cacheEntries[i].valid = 0;
+		}
+	}
+}
+
+/**
+ * Number of downstream frames not acknowledged by the device.
+ */
+uint16_t I2CBridge::getDownstreamNacks(void) {
+	return downstreamNacks;
+}
+
+#endif
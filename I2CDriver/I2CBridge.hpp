@@ -0,0 +1,91 @@
+/* ----------------------------------------------------------------------------
+  I2CBridge.hpp - Bridge of a slave to a downstream I2C bus
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CBRIDGE_HPP_
+#define I2CBRIDGE_HPP_
+
+#include "I2CDriver.hpp"
+
+#if BRIDGE_USAGE == USE_BRIDGE
+
+/** Check consistency of the bridge configuration */
+#ifndef I2C_BRIDGE_ADDRESS_MASK
+#error I2C_BRIDGE_ADDRESS_MASK must be defined
+#elif I2C_BRIDGE_ADDRESS_MASK < 1 || I2C_BRIDGE_ADDRESS_MASK > 0x7F
+#error I2C_BRIDGE_ADDRESS_MASK must be defined with a value between 1 and 0x7F
+#endif
+#if !defined(I2C_BRIDGE_DDR) || !defined(I2C_BRIDGE_PORT) || !defined(I2C_BRIDGE_PIN) \
+		|| !defined(I2C_BRIDGE_SDA) || !defined(I2C_BRIDGE_SCL)
+#error I2C_BRIDGE_DDR, I2C_BRIDGE_PORT, I2C_BRIDGE_PIN, I2C_BRIDGE_SDA and I2C_BRIDGE_SCL must be defined
+#endif
+#ifndef I2C_BRIDGE_HALF_BIT_US
+#error I2C_BRIDGE_HALF_BIT_US must be defined
+#endif
+#ifndef I2C_BRIDGE_CACHE_ENTRIES
+#error I2C_BRIDGE_CACHE_ENTRIES must be defined
+#elif I2C_BRIDGE_CACHE_ENTRIES < 1 || I2C_BRIDGE_CACHE_ENTRIES > 255
+#error I2C_BRIDGE_CACHE_ENTRIES must be defined with a value between 1 and 255
+#endif
+#ifndef I2C_BRIDGE_CACHE_SIZE
+#error I2C_BRIDGE_CACHE_SIZE must be defined
+#elif I2C_BRIDGE_CACHE_SIZE < 1 || I2C_BRIDGE_CACHE_SIZE > 255
+#error I2C_BRIDGE_CACHE_SIZE must be defined with a value between 1 and 255
+#endif
+
+/**
+ * Bridge of the slave to a downstream bus driven by GPIO pins.
+ *
+ * The TWI answers all the addresses which only differ from the address of
+ * the slave by the bits of I2C_BRIDGE_ADDRESS_MASK. The events of the other
+ * addresses are held in the interruption: the upstream clock is stretched
+ * while process forwards the event to the downstream bus, byte by byte.
+ */
+class I2CBridge {
+
+public:
+
+	/* Initialization of the downstream bus and of the address mask, after the I2C driver */
+	void initialisation(void);
+	/* Forward the held event to the downstream bus, must be called in the main loop */
+	void process(void);
+	/* Cache the reads of a register which never changes */
+	uint8_t setStaticRegister(uint8_t address, uint8_t reg, uint8_t length);
+	/* Forget the cached values, they are read again from the devices */
+	void invalidateCache(void);
+	/* Number of downstream transfers not acknowledged by the device */
+	uint16_t getDownstreamNacks(void);
+
+	/* Called by the interruption of the driver, return 0 for the frames of the slave */
+	uint8_t interrupt(uint8_t status);
+};
+
+/** Instantiation of the bridge */
+extern I2CBridge i2cBridge;
+
+#endif
+
+#endif /* I2CBRIDGE_HPP_ */
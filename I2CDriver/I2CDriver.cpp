@@ -29,7 +29,37 @@
 ---------------------------------------------------------------------------- */
 
 #include "I2CDriver.hpp"
+
+#if I2C_CONTROLLER == CONTROLLER_TWI
+
 #include <avr/interrupt.h>
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS && I2C_MODE == MODE_SLAVE
+#include <string.h>
+#include <util/atomic.h>
+#endif
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_SLAVE
+#include <avr/eeprom.h>
+#endif
+#if TIME_SYNC_USAGE == USE_TIME_SYNC || TRACE_USAGE == USE_TRACE
+#include <Arduino.h>
+#endif
+#if (TIME_SYNC_USAGE == USE_TIME_SYNC || BOOTLOADER_USAGE == USE_BOOTLOADER) && I2C_MODE == MODE_SLAVE
+#include <util/atomic.h>
+#endif
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+#include <string.h>
+#include <util/atomic.h>
+#endif
+#if BRIDGE_USAGE == USE_BRIDGE
+#include "I2CBridge.hpp"
+#endif
+#if STREAM_USAGE == USE_STREAM
+#include <string.h>
+#include <util/atomic.h>
+#endif
+#if SLICING_USAGE == USE_SLICING
+#include <util/atomic.h>
+#endif
 
 /* Manage SDA and SCL internal pull-up resistor */
 #define SET_PULLUP_SDA_SCL()        	PORTC &= ~(_BV(PC5) | _BV(PC4))
@@ -64,174 +94,1749 @@
 /** Request send data with ACK */
 #define REQUEST_SEND_WITHOUT_ACK()		TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT)
 
-/** Request receive data with ACK */
-#define REQUEST_RECEIVE_WITH_ACK()		TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA) | _BV(TWINT)
+/** Request receive data with ACK */
+#define REQUEST_RECEIVE_WITH_ACK()		TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA) | _BV(TWINT)
+
+/** Request receive data without ACK */
+#define REQUEST_RECEIVE_WITHOUT_ACK()   TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT)
+
+/** Get communication status */
+#define GET_COMMUNICATION_STATUS() 		TWSR&0xF8
+
+#if I2C_MODE == MODE_SLAVE
+/** Set the slave address, the general call is answered with the address assignment and the time synchronisation */
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT || TIME_SYNC_USAGE == USE_TIME_SYNC
+#define SET_SLAVE_ADDRESS(address)		TWAR = ((address) << 1) | _BV(TWGCE)
+#else
+#define SET_SLAVE_ADDRESS(address)		TWAR = (address) << 1
+#endif
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT
+/** Only the general call is answered by a slave with this address */
+#define GENERAL_CALL_ONLY_ADDRESS		0
+#endif
+
+/** Type of communication */
+static tI2CTypeOfCommunication typeOfCommunication;
+
+/** Status on the driver */
+static volatile tI2CDriverState driverState;
+
+#if I2C_MODE == MODE_MASTER
+/** Pointer on the data buffer to transmit or receive */
+static uint8_t *i2cBuffer;
+
+/** Address for master transmission and reception */
+static uint8_t i2cAddress;
+#endif
+
+#if I2C_MODE == MODE_MASTER
+
+/** Pointer on the current data in the data buffer */
+static uint8_t dataPointer;
+
+/** Pointer to a received buffer */
+static uint8_t *masterReceivedBuffer;
+
+/** Number of data to send */
+static uint8_t nbDataToSend;
+
+#if GATHER_READ_USAGE == USE_GATHER_READ
+/** List of the slave addresses of a gather read */
+static const uint8_t *gatherAddresses;
+
+/** Number of slaves of a gather read */
+static uint8_t gatherNbDevices;
+
+/** Index of the slave currently read */
+static uint8_t gatherDevice;
+
+/** First register of the block to read */
+static uint8_t gatherRegister;
+
+/** Set when the register has been sent to the current slave */
+static uint8_t gatherRegisterSent;
+
+/** Size of each field of the register block */
+static const uint8_t *gatherFieldSizes;
+
+/** Output buffer, one array per field */
+static uint8_t *gatherData;
+
+/** Start of the array of the current field */
+static uint8_t *gatherFieldArray;
+
+/** Index of the current field */
+static uint8_t gatherField;
+
+/** Index of the current byte in the current field */
+static uint8_t gatherFieldByte;
+
+/** Bit n set when the block of the slave n is received */
+static uint8_t gatherResults[(I2C_GATHER_MAX_DEVICES + 7) / 8];
+#endif
+
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+/** End of the current read */
+static tI2CReadMode readMode;
+
+/** End of the next read */
+static tI2CReadMode requestedReadMode;
+
+/** Terminator of a READ_UNTIL_TERMINATOR read */
+static uint8_t readTerminator;
+#endif
+
+#else
+
+static uint8_t slaveDataPointer;
+static uint8_t slaveBuffer[I2C_BUFFER_SIZE];
+static uint8_t * slaveTransmitBuffer;
+static uint8_t nbByteToTransmit;
+static uint8_t slaveTransmitLength;
+#endif
+
+#if I2C_MODE == MODE_SLAVE
+static uint8_t * (*slaveTransmitCallBack)(void);
+static void (*slaveReceiveCallBack)(uint8_t *prtBuffer, uint8_t nbBytes);
+#endif
+
+#if (ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT || TIME_SYNC_USAGE == USE_TIME_SYNC) && I2C_MODE == MODE_SLAVE
+/** Set when the current reception is a general call */
+static uint8_t slaveGeneralCall;
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_SLAVE
+/** Set when the master has assigned an address to the slave */
+static uint8_t slaveAddressAssigned;
+
+/** Unique ID of the slave, read from the EEPROM */
+static uint8_t slaveUid[I2C_UID_SIZE];
+#endif
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC && I2C_MODE == MODE_MASTER
+/** Set when the time must be read at the acknowledge of the address */
+static volatile uint8_t timeSyncCapture;
+
+/** Time of the master at the last SYNC */
+static volatile uint32_t timeSyncMasterTime;
+
+/** Sequence of the last SYNC */
+static uint8_t timeSyncSequence;
+#endif
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC && I2C_MODE == MODE_SLAVE
+/** Local time at the acknowledge of the last general call address */
+static uint32_t generalCallTime;
+
+/** Local time and sequence of the last SYNC, waiting its FOLLOW_UP */
+static uint32_t syncLocalTime;
+static uint8_t syncSequence;
+static uint8_t syncPending;
+
+/** Last pair of times received, not yet used by the clock */
+static volatile uint32_t sampleMasterTime;
+static volatile uint32_t sampleLocalTime;
+static volatile uint8_t sampleReady;
+
+/** Pair of times of the reference of the clock */
+static uint32_t referenceMasterTime;
+static uint32_t referenceLocalTime;
+
+/** Rate correction of the local clock, in 2^-24 */
+static int32_t rateCorrection;
+
+/** Number of pairs of times used by the clock */
+static uint8_t nbSyncSamples;
+#endif
+
+#if TRACE_USAGE == USE_TRACE
+/** Ring buffer of the trace */
+static tI2CTraceRecord traceRecords[I2C_TRACE_SIZE];
+
+/** Oldest request and number of requests of the trace */
+static uint8_t traceHead;
+static uint8_t traceCount;
+
+/** Requests lost because the trace was full */
+static uint16_t traceLost;
+
+/** Time of the previous request */
+static uint32_t tracePreviousStart;
+
+/** Set when the last request waits its status */
+static uint8_t traceOpen;
+#endif
+
+#if STREAM_USAGE == USE_STREAM
+/** Ring buffer of the samples, the application and the interruptions own one index each */
+static uint8_t streamSamples[I2C_STREAM_SAMPLES][I2C_STREAM_SAMPLE_SIZE];
+static volatile uint8_t streamHead;
+static volatile uint8_t streamTail;
+
+/** Sample of the current frame */
+static uint8_t streamSample[I2C_STREAM_SAMPLE_SIZE];
+
+/** Parameters of the stream */
+static uint8_t streamAddress;
+static tI2CStreamDirection streamDirection;
+static tI2CStreamFraming streamFraming;
+static uint8_t streamSampleSize;
+
+/** Set when the continuous frame is held between two samples */
+static volatile uint8_t streamHeld;
+
+/** Set by stopStream to end the continuous frame */
+static volatile uint8_t streamStopping;
+
+/** Counters of the samples not transferred at their period */
+static volatile uint16_t streamUnderruns;
+static volatile uint16_t streamOverruns;
+#endif
+
+#if SLICING_USAGE == USE_SLICING
+/* Address of the memory << 1 */
+static uint8_t sliceAddress;
+/* Memory address of the first byte and its number of bytes */
+static uint16_t sliceMemAddress;
+static uint8_t sliceAddressSize;
+/* Memory address written before a slice, most significant byte first */
+static uint8_t sliceHeader[2];
+static uint8_t *sliceData;
+static uint16_t sliceLength;
+/* Number of bytes already read */
+static uint16_t sliceDone;
+/* The sliced read is not complete */
+static volatile uint8_t sliceActive;
+static volatile tI2CDriverError sliceStatus;
+
+/* Request of the application started at the end of the current slice */
+static volatile uint8_t slicePending;
+static uint8_t slicePendingAddress;
+static uint8_t *slicePendingData;
+static uint8_t slicePendingLength;
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+static tI2CReadMode slicePendingMode;
+/* Number of bytes received by the last request of the application */
+static uint8_t sliceReceivedLength;
+#endif
+#endif
+
+#if BOOTLOADER_USAGE == USE_BOOTLOADER && I2C_MODE == MODE_SLAVE
+/** Set when the slave must not acknowledge its address */
+static volatile uint8_t slaveBusy;
+#endif
+
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS && I2C_MODE == MODE_SLAVE
+/** Statistics of the slave */
+static tI2CSlaveStatistics slaveStatistics;
+
+/** Copy of the statistics transmitted to the master */
+static tI2CSlaveStatistics statisticsSnapshot;
+
+/** Set when the master has selected the statistics for the next read */
+static uint8_t statisticsSelected;
+#endif
+
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+/** Live registers, the frames of the master are staged in slaveBuffer */
+static uint8_t registerMap[I2C_REGISTER_MAP_SIZE];
+
+/** Register read by the next read of the master */
+static uint8_t registerPointer;
+
+/** Set when the last frame has selected a register of the map */
+static uint8_t registerSelected;
+
+/** Set when the master has written the map */
+static volatile uint8_t registerMapChanged;
+
+/** Set when bytes of the current frame were dropped */
+static uint8_t slaveOverrun;
+#endif
+
+/* STatus of the last reception or transmission */
+static volatile tI2CDriverError lastRequestStatus;
+
+/* Instantiation of the I2C driver */
+I2CDriver i2cDriver;
+
+/*
+ * Function twi_releaseBus
+ * Desc     releases bus control
+ * Input    none
+ * Output   none
+ */
+void twi_releaseBus(void) {
+	// release bus
+	TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA) | _BV(TWINT);
+
+	// update twi state
+	driverState = I2C_READY;
+}
+
+#if GATHER_READ_USAGE == USE_GATHER_READ
+/*
+ * Function gatherStartDevice
+ * Desc     start the register block read of the current slave of a gather
+ * Input    none
+ * Output   none
+ */
+static void gatherStartDevice(void) {
+	dataPointer = 0;
+	gatherRegisterSent = 0;
+	gatherField = 0;
+	gatherFieldByte = 0;
+	gatherFieldArray = gatherData;
+	i2cAddress = gatherAddresses[gatherDevice] << 1;
+
+	// Start or repeated start, the address is sent by the interruption
+	SEND_START_CONDITION();
+}
+
+/*
+ * Function gatherNextDevice
+ * Desc     go to the next slave of a gather or end the gather
+ * Input    none
+ * Output   none
+ */
+static void gatherNextDevice(void) {
+	if (++gatherDevice < gatherNbDevices) {
+		gatherStartDevice();
+	} else {
+		SEND_STOP_CONDITION();
+		driverState = I2C_READY;
+	}
+}
+
+/*
+ * Function gatherStoreByte
+ * Desc     store a received byte in the array of its field
+ * Input    value : received byte
+ * Output   none
+ */
+static void gatherStoreByte(uint8_t value) {
+	uint8_t fieldSize = gatherFieldSizes[gatherField];
+
+	gatherFieldArray[gatherDevice * fieldSize + gatherFieldByte] = value;
+	if (++gatherFieldByte == fieldSize) {
+		// Next field array starts after the field of the last slave
+		gatherFieldArray += fieldSize * gatherNbDevices;
+		gatherField++;
+		gatherFieldByte = 0;
+	}
+}
+#endif
+
+#if I2C_MODE == MODE_MASTER
+/*
+ * Function storeReceivedByte
+ * Desc     store a byte received by the master
+ * Input    value : received byte
+ * Output   none
+ */
+static void storeReceivedByte(uint8_t value) {
+#if GATHER_READ_USAGE == USE_GATHER_READ
+	if (typeOfCommunication == MASTER_GATHER) {
+		gatherStoreByte(value);
+		dataPointer++;
+		return;
+	}
+#endif
+	masterReceivedBuffer[dataPointer++] = value;
+}
+#endif
+
+#if I2C_MODE == MODE_MASTER
+/*
+ * Function setRequestStatus
+ * Desc     set the status of the current request, a slice has its own status
+ * Input    status : status of the request
+ * Output   none
+ */
+static void setRequestStatus(tI2CDriverError status) {
+#if SLICING_USAGE == USE_SLICING
+	if (typeOfCommunication == MASTER_SLICE) {
+		sliceStatus = status;
+		return;
+	}
+#endif
+	lastRequestStatus = status;
+}
+#endif
+
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+/*
+ * Function checkEndOfMessage
+ * Desc     shorten the read when a received byte ends the message
+ * Input    value : byte received with ACK
+ * Output   none
+ */
+static void checkEndOfMessage(uint8_t value) {
+	switch (readMode) {
+	case READ_UNTIL_TERMINATOR:
+		if (value == readTerminator) {
+			nbDataToSend = dataPointer;
+		}
+		break;
+
+	case READ_LENGTH_PREFIXED:
+		if (dataPointer == 1) {
+			if (value < nbDataToSend) {
+				nbDataToSend = value + 1;
+			} else {
+				// The buffer is filled, the end of the message is not read
+				setRequestStatus(I2C_MESSAGE_TRUNCATED);
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+#endif
+
+#if TRACE_USAGE == USE_TRACE
+/*
+ * Function traceClose
+ * Desc     store the status of the last request of the trace
+ * Input    none
+ * Output   none
+ */
+static void traceClose(void) {
+	if (traceOpen) {
+		traceRecords[(traceHead + traceCount - 1) % I2C_TRACE_SIZE].status = lastRequestStatus;
+		traceOpen = 0;
+	}
+}
+
+/*
+ * Function traceRequest
+ * Desc     add a request to the trace, the oldest request is lost when full
+ * Input    address : address of the slave << 1, bit 0 set for a read
+ *          length  : number of bytes
+ * Output   none
+ */
+static void traceRequest(uint8_t address, uint8_t length) {
+	uint32_t now = I2C_TRACE_CLOCK();
+	uint32_t interval = now - tracePreviousStart;
+	tI2CTraceRecord *record;
+
+	traceClose();
+	if (traceCount == I2C_TRACE_SIZE) {
+		traceHead = (traceHead + 1) % I2C_TRACE_SIZE;
+		traceCount--;
+		traceLost++;
+	}
+
+	record = &traceRecords[(traceHead + traceCount++) % I2C_TRACE_SIZE];
+	if (interval < 0x8000) {
+		record->interval = interval;
+	} else {
+		interval /= 1000;
+		record->interval = 0x8000 | (interval < 0x7FFF ? interval : 0x7FFF);
+	}
+	record->address = address;
+	record->length = length;
+	tracePreviousStart = now;
+	traceOpen = 1;
+}
+#endif
+
+#if STREAM_USAGE == USE_STREAM
+/** Hold the frame between two samples: the interruption is disabled and TWINT stays set, SCL is held low */
+#define HOLD_STREAM()					TWCR = _BV(TWEN)
+
+/*
+ * Function streamSampleReceived
+ * Desc     add the received sample to the buffer, or count it as lost
+ * Input    none
+ * Output   none
+ */
+static void streamSampleReceived(void) {
+	if ((uint8_t) (streamTail - streamHead) < I2C_STREAM_SAMPLES) {
+		memcpy(streamSamples[streamTail & (I2C_STREAM_SAMPLES - 1)], streamSample, streamSampleSize);
+		streamTail++;
+	} else {
+		streamOverruns++;
+	}
+}
+
+/*
+ * Function streamNextSample
+ * Desc     take the next sample to send
+ * Input    none
+ * Output   0 if the buffer is empty
+ */
+static uint8_t streamNextSample(void) {
+	if (streamHead == streamTail) {
+		streamUnderruns++;
+		return 0;
+	}
+	memcpy(streamSample, streamSamples[streamHead & (I2C_STREAM_SAMPLES - 1)], streamSampleSize);
+	streamHead++;
+	return 1;
+}
+#endif
+
+#if SLICING_USAGE == USE_SLICING
+/** Send a stop condition followed by a start condition */
+#define SEND_STOP_START_CONDITION()		TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA) | _BV(TWINT) | _BV(TWSTO) | _BV(TWSTA)
+
+/*
+ * Function sliceStart
+ * Desc     prepare the next slice, its memory address is written first
+ * Input    none
+ * Output   none
+ */
+static void sliceStart(void) {
+	uint16_t memAddress = sliceMemAddress + sliceDone;
+
+	typeOfCommunication = MASTER_SLICE;
+	sliceHeader[0] = memAddress >> 8;
+	sliceHeader[1] = memAddress;
+	i2cAddress = sliceAddress;
+	i2cBuffer = sliceHeader + sizeof(sliceHeader) - sliceAddressSize;
+	dataPointer = 0;
+	nbDataToSend = sliceAddressSize;
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+	readMode = READ_FIXED_LENGTH;
+#endif
+}
+
+/*
+ * Function sliceRead
+ * Desc     prepare the read of the slice after the memory address
+ * Input    none
+ * Output   none
+ */
+static void sliceRead(void) {
+	uint16_t remaining = sliceLength - sliceDone;
+
+	i2cAddress |= 1;
+	dataPointer = 0;
+	nbDataToSend = remaining < I2C_SLICE_SIZE ? remaining : I2C_SLICE_SIZE;
+	masterReceivedBuffer = sliceData + sliceDone;
+}
+
+/*
+ * Function slicePostpone
+ * Desc     keep a request of the application until the end of the current slice
+ * Input    address : address of the slave << 1, bit 0 set for a read
+ *          data    : data to send or received data
+ *          length  : number of bytes
+ * Output   1 if the request is kept, 0 if no slice is running
+ */
+static uint8_t slicePostpone(uint8_t address, uint8_t *data, uint8_t length) {
+	uint8_t postponed = 0;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (sliceActive && !slicePending && typeOfCommunication == MASTER_SLICE) {
+#if TRACE_USAGE == USE_TRACE
+			traceRequest(address, length);
+#endif
+			slicePendingAddress = address;
+			slicePendingData = data;
+			slicePendingLength = length;
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+			slicePendingMode = (address & 1) ? requestedReadMode : READ_FIXED_LENGTH;
+			requestedReadMode = READ_FIXED_LENGTH;
+#endif
+			slicePending = 1;
+			postponed = 1;
+		}
+	}
+
+	return postponed;
+}
+
+/*
+ * Function sliceNext
+ * Desc     at the end of a transfer, start the postponed request of the
+ *          application or the next slice after a stop condition
+ * Input    none
+ * Output   1 if a transfer is started, 0 if the bus must be released
+ */
+static uint8_t sliceNext(void) {
+	if (typeOfCommunication == MASTER_SLICE) {
+		if (sliceStatus == I2C_OK && (i2cAddress & 1)) {
+			sliceDone += nbDataToSend;
+		}
+		if (sliceStatus != I2C_OK || sliceDone == sliceLength) {
+			sliceActive = 0;
+		}
+	}
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+	else if (typeOfCommunication == MASTER_RECEIVED) {
+		sliceReceivedLength = dataPointer;
+	}
+#endif
+
+	if (slicePending) {
+		slicePending = 0;
+		typeOfCommunication = (slicePendingAddress & 1) ? MASTER_RECEIVED : MASTER_SEND;
+		lastRequestStatus = I2C_OK;
+		i2cAddress = slicePendingAddress;
+		i2cBuffer = slicePendingData;
+		masterReceivedBuffer = slicePendingData;
+		dataPointer = 0;
+		nbDataToSend = slicePendingLength;
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+		readMode = slicePendingMode;
+#endif
+	} else if (sliceActive) {
+		sliceStart();
+	} else {
+		return 0;
+	}
+
+	SEND_STOP_START_CONDITION();
+	return 1;
+}
+#endif
+
+#if I2C_MODE == MODE_MASTER
+/*
+ * Function waitBusFree
+ * Desc     wait the end of the current request and of its stop condition
+ * Input    none
+ * Output   none
+ */
+static void waitBusFree(void) {
+	while (!i2cDriver.isReady())
+		;
+}
+
+/*
+ * Function claimBus
+ * Desc     reserve the driver for a request of the application, the
+ *          interruption of a stream can't start a sample in between
+ * Input    state : state of the driver during the request
+ * Output   1 if the driver was ready and is reserved, 0 if it is busy
+ */
+static uint8_t claimBus(tI2CDriverState state) {
+	uint8_t claimed = 0;
+
+#if STREAM_USAGE == USE_STREAM
+	// Between two framed samples the Timer1 may start a sample after the test
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+	{
+		if (driverState == I2C_READY) {
+			driverState = state;
+			claimed = 1;
+		}
+	}
+
+	return claimed;
+}
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_MASTER
+/*
+ * Function selectUid
+ * Desc     select the unassigned slaves whose UID starts with the first bits of uid
+ * Input    defaultAddress : address of the unassigned slaves
+ *          uid            : UID to compare
+ *          nbBits         : number of bits to compare
+ * Output   1 if at least one slave is selected
+ */
+static uint8_t selectUid(uint8_t defaultAddress, const uint8_t *uid, uint8_t nbBits) {
+	uint8_t frame[2 + I2C_UID_SIZE];
+	uint8_t i;
+
+	frame[0] = GENERAL_CALL_ADDRESS_SELECT;
+	frame[1] = nbBits;
+	for (i = 0; i < I2C_UID_SIZE; i++) {
+		frame[2 + i] = uid[i];
+	}
+	waitBusFree();
+	i2cDriver.sendTo(0, frame, sizeof(frame));
+	waitBusFree();
+
+	// Several selected slaves acknowledge the address together
+	return i2cDriver.probe(defaultAddress);
+}
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_SLAVE
+/*
+ * Function uidMatch
+ * Desc     compare the first bits of an UID with the UID of the slave
+ * Input    uid    : UID to compare
+ *          nbBits : number of bits to compare
+ * Output   1 if the bits are the same
+ */
+static uint8_t uidMatch(const uint8_t *uid, uint8_t nbBits) {
+	uint8_t i;
+
+	for (i = 0; i < nbBits && i < I2C_UID_SIZE * 8; i++) {
+		if ((uid[i >> 3] ^ slaveUid[i >> 3]) & (0x80 >> (i & 7))) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*
+ * Function processGeneralCall
+ * Desc     execute an address assignment command received by general call
+ * Input    buffer : received frame
+ *          size   : size of the frame
+ * Output   1 if the frame was an address assignment command
+ */
+static uint8_t processGeneralCall(uint8_t *buffer, uint8_t size) {
+	if (size == 0) {
+		return 0;
+	}
+
+	switch (buffer[0]) {
+	case GENERAL_CALL_ADDRESS_RESET:
+		slaveAddressAssigned = 0;
+		SET_SLAVE_ADDRESS(I2C_ADDRESS);
+		return 1;
+
+	case GENERAL_CALL_ADDRESS_SELECT:
+		if (size >= 2 + I2C_UID_SIZE && !slaveAddressAssigned) {
+			if (uidMatch(&buffer[2], buffer[1])) {
+				SET_SLAVE_ADDRESS(I2C_ADDRESS);
+			} else {
+				SET_SLAVE_ADDRESS(GENERAL_CALL_ONLY_ADDRESS);
+			}
+		}
+		return 1;
+
+	case GENERAL_CALL_ADDRESS_ASSIGN:
+		if (size >= 2 + I2C_UID_SIZE && !slaveAddressAssigned) {
+			if (uidMatch(&buffer[1], I2C_UID_SIZE * 8)) {
+				slaveAddressAssigned = 1;
+				SET_SLAVE_ADDRESS(buffer[1 + I2C_UID_SIZE]);
+			}
+		}
+		return 1;
+	}
+	return 0;
+}
+#endif
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC && I2C_MODE == MODE_SLAVE
+/*
+ * Function processTimeSync
+ * Desc     execute a time synchronisation command received by general call
+ * Input    buffer : received frame
+ *          size   : size of the frame
+ * Output   1 if the frame was a time synchronisation command
+ */
+static uint8_t processTimeSync(uint8_t *buffer, uint8_t size) {
+	if (size < 2) {
+		return 0;
+	}
+
+	switch (buffer[0]) {
+	case GENERAL_CALL_TIME_SYNC:
+		syncLocalTime = generalCallTime;
+		syncSequence = buffer[1];
+		syncPending = 1;
+		return 1;
+
+	case GENERAL_CALL_TIME_FOLLOW_UP:
+		if (size >= 6 && syncPending && buffer[1] == syncSequence) {
+			// The clock is updated out of the interruption
+			sampleMasterTime = ((uint32_t) buffer[2] | ((uint32_t) buffer[3] << 8)
+					| ((uint32_t) buffer[4] << 16) | ((uint32_t) buffer[5] << 24)) + I2C_TIME_SYNC_LATENCY;
+			sampleLocalTime = syncLocalTime;
+			sampleReady = 1;
+		}
+		syncPending = 0;
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * Function updateBusClock
+ * Desc     take the last pair of times: the time of the master is the new
+ *          reference, the rate correction follows the rate measured since
+ *          the previous reference
+ * Input    none
+ * Output   none
+ */
+static void updateBusClock(void) {
+	uint32_t masterTime;
+	uint32_t localTime;
+	int32_t localElapsed;
+	int32_t measured;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (!sampleReady) {
+			return;
+		}
+		masterTime = sampleMasterTime;
+		localTime = sampleLocalTime;
+		sampleReady = 0;
+	}
+
+	localElapsed = (int32_t) (localTime - referenceLocalTime);
+	if (nbSyncSamples > 0 && localElapsed > 0) {
+		measured = (int32_t) ((((int64_t) (int32_t) (masterTime - referenceMasterTime) - localElapsed) << 24)
+				/ localElapsed);
+		if (nbSyncSamples == 1) {
+			rateCorrection = measured;
+		} else {
+			// Low pass filter of the jitter of the timestamps
+			rateCorrection += (measured - rateCorrection) / 4;
+		}
+	}
+	if (nbSyncSamples < 2) {
+		nbSyncSamples++;
+	}
+
+	referenceMasterTime = masterTime;
+	referenceLocalTime = localTime;
+}
+#endif
+
+#if I2C_MODE == MODE_SLAVE
+/*
+ * Function slaveStoreByte
+ * Desc     store a byte received by the slave, drop it if the buffer is full
+ * Input    value : received byte
+ * Output   none
+ */
+static void slaveStoreByte(uint8_t value) {
+	if (slaveDataPointer < I2C_BUFFER_SIZE) {
+		slaveBuffer[slaveDataPointer++] = value;
+		return;
+	}
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+	slaveStatistics.overruns++;
+#endif
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+	slaveOverrun = 1;
+#endif
+}
+
+/*
+ * Function slaveFrameReceived
+ * Desc     give a frame received by the slave to its user
+ * Input    none
+ * Output   none
+ */
+static void slaveFrameReceived(void) {
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+	// The selection of the statistics is handled by the driver
+	statisticsSelected = slaveDataPointer == 1 && slaveBuffer[0] == I2C_STATISTICS_REGISTER;
+	if (statisticsSelected) {
+		return;
+	}
+	slaveStatistics.framesReceived++;
+	slaveStatistics.bytesReceived += slaveDataPointer;
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT
+	if (slaveGeneralCall && processGeneralCall(slaveBuffer, slaveDataPointer)) {
+		return;
+	}
+#endif
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC
+	if (slaveGeneralCall && processTimeSync(slaveBuffer, slaveDataPointer)) {
+		return;
+	}
+#endif
+
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+	registerSelected = slaveDataPointer > 0 && slaveBuffer[0] < I2C_REGISTER_MAP_SIZE;
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT || TIME_SYNC_USAGE == USE_TIME_SYNC
+	// The map is not written by the general calls
+	registerSelected = registerSelected && !slaveGeneralCall;
+#endif
+	if (registerSelected) {
+		uint8_t length = slaveDataPointer - 1;
+
+		registerPointer = slaveBuffer[0];
+		// Only the written registers are copied, a truncated frame is dropped
+		if (length > 0 && !slaveOverrun) {
+			if (length > I2C_REGISTER_MAP_SIZE - registerPointer) {
+				length = I2C_REGISTER_MAP_SIZE - registerPointer;
+			}
+			memcpy(&registerMap[registerPointer], &slaveBuffer[1], length);
+			registerMapChanged = 1;
+		}
+		return;
+	}
+#endif
+
+	// An empty write is a probe of the master, it carries no message
+	if (slaveDataPointer > 0) {
+		slaveReceiveCallBack(slaveBuffer, slaveDataPointer);
+	}
+}
+#endif
+
+/**
+ * Initialization of the I2C driver.
+ */
+void I2CDriver::initialisation(void) {
+	// initialize state
+	driverState = I2C_READY;
+
+#if PULL_UP_USAGE == USE_PULL_UP
+	SET_PULLUP_SDA_SCL();
+#endif
+
+#if I2C_MODE == MODE_MASTER
+	// set pull up  on SDA and SCL
+
+	// Set I2C prescaler at 1
+	SET_I2C_PRESCALER_1();
+
+	// Set I2C frequency
+	TWBR = FREQUENCY_REGISTER_VALUE();
+#endif
+
+	// Activate the I2C
+	ENABLE_I2C();
+
+#if I2C_MODE == MODE_SLAVE
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT
+	eeprom_read_block(slaveUid, (const void*) I2C_UID_EEPROM_ADDRESS, I2C_UID_SIZE);
+	slaveAddressAssigned = 0;
+#endif
+	SET_SLAVE_ADDRESS(I2C_ADDRESS);
+#endif
+}
+
+/**
+ * Disable the I2C bus
+ */
+void I2CDriver::disable() {
+	// disable twi module, acks, and twi interrupt
+	TWCR &= ~(_BV(TWEN) | _BV(TWIE) | _BV(TWEA));
+
+	// deactivate internal pullups for twi.
+	REMOVE_PULLUP_SDA_SCL();
+}
+
+/**
+ * Check if the driver is ready for a new request.
+ *
+ * return   : 1 if no transfer and no stop condition are running, 0 otherwise
+ */
+uint8_t I2CDriver::isReady(void) {
+#if SLICING_USAGE == USE_SLICING
+	// A request is accepted during a slice, it runs at the end of the slice
+	if (sliceActive) {
+		return !slicePending && typeOfCommunication == MASTER_SLICE;
+	}
+#endif
+	return driverState == I2C_READY && !(TWCR & _BV(TWSTO));
+}
+
+/**
+ * Send data to a slave define by an address.
+ *
+ * address  : address of a slave
+ * data     : Data to send
+ * length   : Number of byte to send
+ */
+#if I2C_MODE == MODE_MASTER
+uint8_t I2CDriver::sendTo(uint8_t address, uint8_t *data, uint8_t length) {
+	uint8_t i;
+
+#if SLICING_USAGE == USE_SLICING
+	if (slicePostpone(address << 1, data, length)) {
+		return 0;
+	}
+#endif
+	if (claimBus(I2C_MASTER_TRANSMIT)) {
+#if TRACE_USAGE == USE_TRACE
+		traceRequest(address << 1, length);
+#endif
+		typeOfCommunication = MASTER_SEND;
+		lastRequestStatus = I2C_OK;
+
+		/* Initialize the data buffer */
+		dataPointer = 0;
+		nbDataToSend = length;
+
+		/* copy data to send in the buffer */
+		i2cAddress = address << 1;
+		i2cBuffer = data;
+
+		// initiate the transmission
+		SEND_START_CONDITION();
+	}
+
+	return 0;
+}
+#endif
+
+#if I2C_MODE == MODE_MASTER
+/**
+ * Received data from a slave define by an address.
+ *
+ * address  : address of a slave
+ * data     : Data to send
+ * length   : Number of byte to receive
+ */
+uint8_t I2CDriver::readFrom(uint8_t address, uint8_t *data, uint8_t length) {
+
+#if SLICING_USAGE == USE_SLICING
+	if (slicePostpone((address << 1) + 1, data, length)) {
+		return 0;
+	}
+#endif
+	if (claimBus(I2C_MASTER_TRANSMIT)) {
+		uint8_t i;
+
+#if TRACE_USAGE == USE_TRACE
+		traceRequest((address << 1) + 1, length);
+#endif
+		typeOfCommunication = MASTER_RECEIVED;
+		lastRequestStatus = I2C_OK;
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+		readMode = requestedReadMode;
+		requestedReadMode = READ_FIXED_LENGTH;
+#endif
+
+		/* Initialize the data buffer */
+		dataPointer = 0;
+		nbDataToSend = length;
+		masterReceivedBuffer = data;
+
+		/* copy data to send in the buffer */
+		i2cAddress = (address << 1) + 1;
+		i2cBuffer = data;
+
+		// initiate the transmission
+		SEND_START_CONDITION();
+	}
+
+	return 0;
+}
+#endif
+
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+/**
+ * Received data from a slave until a terminator byte.
+ * The terminator is stored with the data. As the ACK of a byte is sent
+ * before its value is known, the byte following the terminator is read
+ * with NACK and dropped.
+ *
+ * address    : address of a slave
+ * data       : Received data
+ * length     : Maximal number of byte to receive
+ * terminator : Last byte of the message
+ */
+uint8_t I2CDriver::readUntil(uint8_t address, uint8_t *data, uint8_t length, uint8_t terminator) {
+	// isReady also accepts the request during a slice
+	if (driverState == I2C_READY || isReady()) {
+		requestedReadMode = READ_UNTIL_TERMINATOR;
+		readTerminator = terminator;
+		readFrom(address, data, length);
+	}
+
+	return 0;
+}
+
+/**
+ * Received data from a slave, the first byte is the number of following bytes.
+ * The read ends with the last byte of the message, a message longer than
+ * length ends the request with I2C_MESSAGE_TRUNCATED.
+ *
+ * address  : address of a slave
+ * data     : Received data, length byte included
+ * length   : Maximal number of byte to receive
+ */
+uint8_t I2CDriver::readLengthPrefixed(uint8_t address, uint8_t *data, uint8_t length) {
+	if (driverState == I2C_READY || isReady()) {
+		requestedReadMode = READ_LENGTH_PREFIXED;
+		readFrom(address, data, length);
+	}
+
+	return 0;
+}
+
+/**
+ * Number of bytes received by the last read.
+ */
+uint8_t I2CDriver::getReceivedLength(void) {
+#if SLICING_USAGE == USE_SLICING
+	// dataPointer is used by the slices which follow the request
+	if (typeOfCommunication == MASTER_SLICE) {
+		return sliceReceivedLength;
+	}
+#endif
+	return dataPointer;
+}
+#endif
+
+#if I2C_MODE == MODE_MASTER
+/**
+ * Check if a slave acknowledges its address.
+ * Wait the end of the current request, then send an empty write.
+ *
+ * address  : address of a slave
+ * return   : 1 if the slave acknowledges, 0 otherwise
+ */
+uint8_t I2CDriver::probe(uint8_t address) {
+	waitBusFree();
+	sendTo(address, 0, 0);
+	waitBusFree();
+
+	return lastRequestStatus == I2C_OK;
+}
+
+/**
+ * Status of the last request.
+ */
+tI2CDriverError I2CDriver::getLastStatus(void) {
+	return lastRequestStatus;
+}
+#endif
+
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS && I2C_MODE == MODE_MASTER
+/**
+ * Read the statistics of a slave.
+ * The statistics register is written, then the statistics are read. The
+ * function waits the end of the read.
+ *
+ * address    : address of a slave
+ * statistics : received statistics
+ * return     : status of the read
+ */
+tI2CDriverError I2CDriver::readStatistics(uint8_t address, tI2CSlaveStatistics *statistics) {
+	uint8_t reg = I2C_STATISTICS_REGISTER;
+
+	waitBusFree();
+	sendTo(address, &reg, 1);
+	waitBusFree();
+	if (lastRequestStatus != I2C_OK) {
+		return lastRequestStatus;
+	}
+
+	readFrom(address, (uint8_t*) statistics, sizeof(tI2CSlaveStatistics));
+	waitBusFree();
+
+	return lastRequestStatus;
+}
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_MASTER
+/**
+ * Give an address to every unassigned slave.
+ * The UID of one unassigned slave is found bit by bit: the slaves whose UID
+ * starts with the bits already found and a 0 are selected, if none of them
+ * acknowledges the default address, the bit is a 1. The slave with the UID
+ * found receives the next free address, an address acknowledged by another
+ * slave is skipped. An assignment is counted when the slave acknowledges its
+ * new address. The function waits the end of the enumeration.
+ *
+ * defaultAddress : address of the unassigned slaves (their I2C_ADDRESS),
+ *                  outside firstAddress..lastAddress
+ * firstAddress   : first address to assign
+ * lastAddress    : last address to assign, at most 127
+ * return         : number of assigned slaves, 0 if the addresses are invalid
+ */
+uint8_t I2CDriver::assignAddresses(uint8_t defaultAddress, uint8_t firstAddress, uint8_t lastAddress) {
+	uint8_t frame[2 + I2C_UID_SIZE];
+	uint8_t uid[I2C_UID_SIZE];
+	uint8_t nbAssigned = 0;
+	uint8_t address;
+	uint8_t bit;
+	uint8_t i;
+
+	// The default address would be assigned to a slave while the others still use it
+	if (firstAddress > lastAddress || lastAddress > 127
+			|| (defaultAddress >= firstAddress && defaultAddress <= lastAddress)) {
+		return 0;
+	}
+
+	// Every slave goes back to its default address
+	frame[0] = GENERAL_CALL_ADDRESS_RESET;
+	waitBusFree();
+	sendTo(0, frame, 1);
+
+	for (address = firstAddress; address <= lastAddress; address++) {
+		// The address is used by a slave which is not enumerated
+		if (probe(address)) {
+			continue;
+		}
+
+		for (i = 0; i < I2C_UID_SIZE; i++) {
+			uid[i] = 0;
+		}
+
+		// Any unassigned slave left ?
+		if (!selectUid(defaultAddress, uid, 0)) {
+			break;
+		}
+
+		for (bit = 0; bit < I2C_UID_SIZE * 8; bit++) {
+			if (!selectUid(defaultAddress, uid, bit + 1)) {
+				uid[bit >> 3] |= 0x80 >> (bit & 7);
+			}
+		}
+
+		frame[0] = GENERAL_CALL_ADDRESS_ASSIGN;
+		for (i = 0; i < I2C_UID_SIZE; i++) {
+			frame[1 + i] = uid[i];
+		}
+		frame[1 + I2C_UID_SIZE] = address;
+		waitBusFree();
+		sendTo(0, frame, sizeof(frame));
+
+		// A slave which missed the command is found again for the next address
+		if (probe(address)) {
+			nbAssigned++;
+		}
+	}
+	waitBusFree();
+
+	return nbAssigned;
+}
+#endif
+
+#if TRACE_USAGE == USE_TRACE
+/**
+ * Remove the oldest request of the trace.
+ * The last request is kept until its end, to store its status.
+ *
+ * record   : request
+ * return   : 1 if a request is removed, 0 if no request is complete
+ */
+uint8_t I2CDriver::getTraceRecord(tI2CTraceRecord *record) {
+	if (traceOpen && isReady()) {
+		traceClose();
+	}
+	if (traceCount == 0 || (traceOpen && traceCount == 1)) {
+		return 0;
+	}
+
+	*record = traceRecords[traceHead];
+	traceHead = (traceHead + 1) % I2C_TRACE_SIZE;
+	traceCount--;
+	return 1;
+}
+
+/**
+ * Number of requests lost because the trace was full.
+ */
+uint16_t I2CDriver::getTraceLost(void) {
+	return traceLost;
+}
+#endif
+
+#if STREAM_USAGE == USE_STREAM
+/**
+ * Start the transfer of a sample each period. The frames are started by
+ * the interruption of the Timer1 (CTC mode, prescaler 8) and continued by
+ * the interruption of the TWI, the application only fills or empties the
+ * buffer. The bus belongs to the stream until stopStream, a continuous
+ * stream keeps it between the samples.
+ *
+ * address    : address of the slave
+ * direction  : STREAM_OUTPUT to write the samples, STREAM_INPUT to read them
+ * framing    : STREAM_FRAMED or STREAM_CONTINUOUS
+ * sampleSize : number of bytes of a sample, at most I2C_STREAM_SAMPLE_SIZE
+ * periodUs   : period of the samples in microseconds
+ * return     : 0 if a stream is running, the driver is busy or the parameters
+ *              are out of range
+ */
+uint8_t I2CDriver::startStream(uint8_t address, tI2CStreamDirection direction, tI2CStreamFraming framing,
+		uint8_t sampleSize, uint16_t periodUs) {
+	uint32_t ticks = (uint32_t) periodUs * (F_CPU / 1000000UL) / 8;
+
+	if (sampleSize == 0 || sampleSize > I2C_STREAM_SAMPLE_SIZE || ticks == 0 || ticks > 0x10000UL) {
+		return 0;
+	}
+	// A continuous stream keeps the driver busy, waitBusFree would never return
+	if (TIMSK1 & _BV(OCIE1A)) {
+		return 0;
+	}
+#if SLICING_USAGE == USE_SLICING
+	// isReady returns 1 during the slices, a stream can't wait in the slot of the postponed request
+	if (sliceActive) {
+		return 0;
+	}
+#endif
+	waitBusFree();
+
+	streamAddress = address;
+	streamDirection = direction;
+	streamFraming = framing;
+	streamSampleSize = sampleSize;
+	streamHeld = 0;
+	streamStopping = 0;
+	streamUnderruns = 0;
+	streamOverruns = 0;
+	if (direction == STREAM_INPUT) {
+		streamHead = streamTail;
+	}
+
+	TCCR1A = 0;
+	TCCR1B = _BV(WGM12) | _BV(CS11);
+	OCR1A = ticks - 1;
+	TCNT1 = 0;
+	TIMSK1 |= _BV(OCIE1A);
+	return 1;
+}
+
+/**
+ * Stop the stream. A continuous output frame ends with a stop condition,
+ * a continuous input frame with a byte not acknowledged and dropped.
+ */
+void I2CDriver::stopStream(void) {
+	TIMSK1 &= ~_BV(OCIE1A);
+	TCCR1B = 0;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		streamStopping = 1;
+		if (streamHeld) {
+			streamHeld = 0;
+			if (streamDirection == STREAM_OUTPUT) {
+				SEND_STOP_CONDITION();
+				driverState = I2C_READY;
+			} else {
+				// The byte is not stored, the frame ends with its NACK
+				dataPointer = nbDataToSend;
+				REQUEST_SEND_WITHOUT_ACK();
+			}
+		}
+	}
+	waitBusFree();
+}
+
+/**
+ * Add a sample to an output stream.
+ *
+ * sample   : sampleSize bytes
+ * return   : 0 if the buffer is full
+ */
+uint8_t I2CDriver::writeStreamSample(const uint8_t *sample) {
+	if ((uint8_t) (streamTail - streamHead) >= I2C_STREAM_SAMPLES) {
+		return 0;
+	}
+	memcpy(streamSamples[streamTail & (I2C_STREAM_SAMPLES - 1)], sample, streamSampleSize);
+	streamTail++;
+	return 1;
+}
+
+/**
+ * Remove a sample from an input stream.
+ *
+ * sample   : sampleSize bytes
+ * return   : 0 if the buffer is empty
+ */
+uint8_t I2CDriver::readStreamSample(uint8_t *sample) {
+	if (streamHead == streamTail) {
+		return 0;
+	}
+	memcpy(sample, streamSamples[streamHead & (I2C_STREAM_SAMPLES - 1)], streamSampleSize);
+	streamHead++;
+	return 1;
+}
+
+/**
+ * Number of samples in the buffer.
+ */
+uint8_t I2CDriver::getStreamCount(void) {
+	return streamTail - streamHead;
+}
+
+/**
+ * Number of periods of an output stream without sample in the buffer.
+ */
+uint16_t I2CDriver::getStreamUnderruns(void) {
+	uint16_t underruns;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		underruns = streamUnderruns;
+	}
+	return underruns;
+}
+
+/**
+ * Number of samples lost: input samples received with the buffer full, and
+ * periods of a framed stream where the bus was still busy.
+ */
+uint16_t I2CDriver::getStreamOverruns(void) {
+	uint16_t overruns;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		overruns = streamOverruns;
+	}
+	return overruns;
+}
 
-/** Request receive data without ACK */
-#define REQUEST_RECEIVE_WITHOUT_ACK()   TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT)
+/**
+ * Interruption of the Timer1, start or continue the frame of a sample.
+ */
+ISR(TIMER1_COMPA_vect) {
+	if (streamHeld) {
+		if (streamDirection == STREAM_OUTPUT) {
+			// The frame stays held until a sample is available
+			if (!streamNextSample()) {
+				return;
+			}
+			streamHeld = 0;
+			dataPointer = 0;
+			TWDR = streamSample[dataPointer++];
+			REQUEST_SEND_WITH_ACK();
+		} else {
+			streamHeld = 0;
+			dataPointer = 0;
+			REQUEST_SEND_WITH_ACK();
+		}
+		return;
+	}
 
-/** Get communication status */
-#define GET_COMMUNICATION_STATUS() 		TWSR&0xF8
+	if (driverState != I2C_READY) {
+		streamOverruns++;
+		return;
+	}
+	if (streamDirection == STREAM_OUTPUT && !streamNextSample()) {
+		return;
+	}
 
-/** Type of communication */
-static tI2CTypeOfCommunication typeOfCommunication;
+	typeOfCommunication = MASTER_STREAM;
+	driverState = I2C_MASTER_TRANSMIT;
+	lastRequestStatus = I2C_OK;
+	dataPointer = 0;
+	nbDataToSend = streamSampleSize;
+	i2cBuffer = streamSample;
+	masterReceivedBuffer = streamSample;
+	i2cAddress = (streamAddress << 1) | (streamDirection == STREAM_INPUT);
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+	readMode = READ_FIXED_LENGTH;
+#endif
+	SEND_START_CONDITION();
+}
+#endif
 
-/** Status on the driver */
-static tI2CDriverState driverState;
+#if SLICING_USAGE == USE_SLICING
+/**
+ * Read a memory with address auto-increment in slices of at most
+ * I2C_SLICE_SIZE bytes. Each slice writes the memory address of its first
+ * byte, then reads its bytes after a repeated start. A request of the
+ * application (sendTo, readFrom) is started at the end of the current
+ * slice, then the read resumes: isReady returns 1 while only the slices are
+ * running, and a request waits at most one slice.
+ *
+ * address     : address of the memory
+ * memAddress  : memory address of the first byte
+ * addressSize : number of bytes of the memory address, 1 or 2
+ * data        : received data
+ * length      : number of bytes to read
+ * return      : 0 if the driver is busy or the parameters are out of range
+ */
+uint8_t I2CDriver::readMemory(uint8_t address, uint16_t memAddress, uint8_t addressSize, uint8_t *data,
+		uint16_t length) {
+	// isReady returns 1 during the slices of a previous read
+	if (addressSize < 1 || addressSize > 2 || length == 0 || sliceActive || !isReady()
+			|| !claimBus(I2C_MASTER_TRANSMIT)) {
+		return 0;
+	}
 
-#if I2C_MODE == MODE_MASTER
-/** Pointer on the data buffer to transmit or receive */
-static uint8_t *i2cBuffer;
+	sliceAddress = address << 1;
+	sliceMemAddress = memAddress;
+	sliceAddressSize = addressSize;
+	sliceData = data;
+	sliceLength = length;
+	sliceDone = 0;
+	sliceStatus = I2C_OK;
+	sliceActive = 1;
+	sliceStart();
+
+	SEND_START_CONDITION();
+	return 1;
+}
 
-/** Address for master transmission and reception */
-static uint8_t i2cAddress;
+/**
+ * Check if the sliced read of the memory is complete.
+ */
+uint8_t I2CDriver::isMemoryReadDone(void) {
+	return !sliceActive;
+}
+
+/**
+ * Status of the sliced read of the memory, the read stops at the first error.
+ */
+tI2CDriverError I2CDriver::getMemoryReadStatus(void) {
+	return sliceStatus;
+}
 #endif
 
-#if I2C_MODE == MODE_MASTER
+#if TIME_SYNC_USAGE == USE_TIME_SYNC && I2C_MODE == MODE_MASTER
+/**
+ * Send the time of the master to the slaves.
+ * A SYNC general call is sent, the master reads its clock when the general
+ * call address is acknowledged and sends this time in a FOLLOW_UP general
+ * call. The function waits the end of the two frames.
+ *
+ * return   : status of the frames
+ */
+tI2CDriverError I2CDriver::sendTimeSync(void) {
+	uint8_t frame[6];
+	uint32_t masterTime;
+
+	frame[0] = GENERAL_CALL_TIME_SYNC;
+	frame[1] = ++timeSyncSequence;
+	waitBusFree();
+	timeSyncCapture = 1;
+	sendTo(0, frame, 2);
+	waitBusFree();
+	timeSyncCapture = 0;
+	if (lastRequestStatus != I2C_OK) {
+		return lastRequestStatus;
+	}
 
-/** Pointer on the current data in the data buffer */
-static uint8_t dataPointer;
+	masterTime = timeSyncMasterTime;
+	frame[0] = GENERAL_CALL_TIME_FOLLOW_UP;
+	frame[2] = masterTime & 0xFF;
+	frame[3] = (masterTime >> 8) & 0xFF;
+	frame[4] = (masterTime >> 16) & 0xFF;
+	frame[5] = masterTime >> 24;
+	sendTo(0, frame, sizeof(frame));
+	waitBusFree();
 
-/** Pointer to a received buffer */
-static uint8_t *masterReceivedBuffer;
+	return lastRequestStatus;
+}
+#endif
 
-/** Number of data to send */
-static uint8_t nbDataToSend;
+#if GATHER_READ_USAGE == USE_GATHER_READ
+/**
+ * Read the same register block from several identical slaves in one sweep.
+ * The slaves are read one after the other, linked by repeated starts.
+ * Each field of the block is stored in its own array of nbDevices elements,
+ * the arrays follow each other in data in the order of the fields.
+ *
+ * addresses  : addresses of the slaves
+ * nbDevices  : number of slaves
+ * reg        : first register of the block
+ * fieldSizes : size in bytes of each field of the block
+ * nbFields   : number of fields of the block
+ * data       : output buffer, nbDevices times the size of the block
+ * dataSize   : size of the output buffer
+ * return     : GATHER_STARTED, GATHER_BUSY or GATHER_INVALID
+ */
+tI2CGatherStatus I2CDriver::gatherFrom(const uint8_t *addresses, uint8_t nbDevices, uint8_t reg,
+		const uint8_t *fieldSizes, uint8_t nbFields, uint8_t *data, uint16_t dataSize) {
+	uint16_t blockSize = 0;
+	uint8_t field;
+	uint8_t i;
 
-#else
+	if (nbDevices == 0 || nbDevices > I2C_GATHER_MAX_DEVICES || nbFields == 0) {
+		return GATHER_INVALID;
+	}
+	// A field of 0 byte would never end, its bytes would be stored in the slot of the next slave
+	for (field = 0; field < nbFields; field++) {
+		if (fieldSizes[field] == 0) {
+			return GATHER_INVALID;
+		}
+		blockSize += fieldSizes[field];
+	}
+	if (blockSize > 255 || (uint32_t) blockSize * nbDevices > dataSize) {
+		return GATHER_INVALID;
+	}
 
-static uint8_t slaveDataPointer;
-static uint8_t slaveBuffer[I2C_BUFFER_SIZE];
-static uint8_t * slaveTransmitBuffer;
-static uint8_t nbByteToTransmit;
-#endif
+	// A sliced read keeps the driver busy, the sweep is too long for the slot of the postponed request
+	if (claimBus(I2C_MASTER_RECEIVE)) {
+		typeOfCommunication = MASTER_GATHER;
+		lastRequestStatus = I2C_OK;
+		for (i = 0; i < sizeof(gatherResults); i++) {
+			gatherResults[i] = 0;
+		}
 
-#if I2C_MODE == MODE_SLAVE
-static uint8_t * (*slaveTransmitCallBack)(void);
-static void (*slaveReceiveCallBack)(uint8_t prtBuffer, uint8_t nbBytes);
+		/* Size of the register block */
+		nbDataToSend = blockSize;
+
+		gatherAddresses = addresses;
+		gatherNbDevices = nbDevices;
+		gatherDevice = 0;
+		gatherRegister = reg;
+		gatherFieldSizes = fieldSizes;
+		gatherData = data;
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+		readMode = READ_FIXED_LENGTH;
 #endif
 
-/* STatus of the last reception or transmission */
-static volatile tI2CDriverError lastRequestStatus;
+		// initiate the transmission
+		gatherStartDevice();
+		return GATHER_STARTED;
+	}
 
-/* Instantiation of the I2C driver */
-I2CDriver i2cDriver;
+	return GATHER_BUSY;
+}
 
-/*
- * Function twi_releaseBus
- * Desc     releases bus control
- * Input    none
- * Output   none
+/**
+ * Bitmap of the results of the last gather read, the bit (n & 7) of the
+ * byte n / 8 is set when the whole block of the slave n is received.
+ * Valid when the driver is ready again.
  */
-void twi_releaseBus(void) {
-	// release bus
-	TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWEA) | _BV(TWINT);
-
-	// update twi state
-	driverState = I2C_READY;
+const uint8_t* I2CDriver::getGatherResults(void) {
+	return gatherResults;
 }
+#endif
 
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS && I2C_MODE == MODE_SLAVE
 /**
- * Initialization of the I2C driver.
+ * Copy the statistics of the slave.
+ * maxInterruptTime is in ticks of I2C_STATISTICS_TIMER, I2C_STATISTICS_TICK_NS
+ * nanoseconds each. The measure is rounded to one tick: with TCNT0 (4 us at
+ * 16 MHz) an interruption of a few microseconds reads 0 or 1 tick.
+ *
+ * statistics : copy of the statistics
  */
-void I2CDriver::initialisation(void) {
-	// initialize state
-	driverState = I2C_READY;
-
-#if PULL_UP_USAGE == USE_PULL_UP
-	SET_PULLUP_SDA_SCL();
+void I2CDriver::getStatistics(tI2CSlaveStatistics *statistics) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memcpy(statistics, &slaveStatistics, sizeof(tI2CSlaveStatistics));
+	}
+}
 #endif
 
-#if I2C_MODE == MODE_MASTER
-	// set pull up  on SDA and SCL
-
-	// Set I2C prescaler at 1
-	SET_I2C_PRESCALER_1();
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_SLAVE
+/**
+ * Check if the master has assigned an address to the slave.
+ */
+uint8_t I2CDriver::isAddressAssigned(void) {
+	return slaveAddressAssigned;
+}
 
-	// Set I2C frequency
-	TWBR = FREQUENCY_REGISTER_VALUE();
+/**
+ * Current address of the slave.
+ */
+uint8_t I2CDriver::getSlaveAddress(void) {
+	return TWAR >> 1;
+}
 #endif
 
-	// Activate the I2C
-	ENABLE_I2C();
-
-#if I2C_MODE == MODE_SLAVE
-	TWAR = I2C_ADDRESS<<1;
-#endif
+#if TIME_SYNC_USAGE == USE_TIME_SYNC && I2C_MODE == MODE_SLAVE
+/**
+ * Check if the slave has received the time of the master.
+ */
+uint8_t I2CDriver::isTimeSynchronised(void) {
+	updateBusClock();
+	return nbSyncSamples > 0;
 }
 
 /**
- * Disable the I2C bus
+ * Time of the master, from the local clock corrected with the last time
+ * received and the rate correction.
+ *
+ * return   : time of the master in microseconds
  */
-void I2CDriver::disable() {
-	// disable twi module, acks, and twi interrupt
-	TWCR &= ~(_BV(TWEN) | _BV(TWIE) | _BV(TWEA));
+uint32_t I2CDriver::getBusTime(void) {
+	int32_t localElapsed;
 
-	// deactivate internal pullups for twi.
-	REMOVE_PULLUP_SDA_SCL();
+	updateBusClock();
+	localElapsed = (int32_t) (I2C_TIME_SYNC_CLOCK() - referenceLocalTime);
+
+	return referenceMasterTime + localElapsed + (int32_t) (((int64_t) localElapsed * rateCorrection) >> 24);
 }
 
 /**
- * Send data to a slave define by an address.
+ * Local clock value at a time of the master, to schedule an action on the
+ * time of the master.
  *
- * address  : address of a slave
- * data     : Data to send
- * length   : Number of byte to send
+ * busTime  : time of the master in microseconds
+ * return   : value of I2C_TIME_SYNC_CLOCK() at this time
  */
-#if I2C_MODE == MODE_MASTER
-uint8_t I2CDriver::sendTo(uint8_t address, uint8_t *data, uint8_t length) {
-	uint8_t i;
+uint32_t I2CDriver::toLocalTime(uint32_t busTime) {
+	int32_t masterElapsed;
 
-	if (driverState == I2C_READY) {
-		typeOfCommunication = MASTER_SEND;
-		driverState = I2C_MASTER_TRANSMIT;
+	updateBusClock();
+	masterElapsed = (int32_t) (busTime - referenceMasterTime);
 
-		/* Initialize the data buffer */
-		dataPointer = 0;
-		nbDataToSend = length;
+	return referenceLocalTime + masterElapsed - (int32_t) (((int64_t) masterElapsed * rateCorrection) >> 24);
+}
 
-		/* copy data to send in the buffer */
-		i2cAddress = address << 1;
-		i2cBuffer = data;
+/**
+ * Drift of the local clock from the clock of the master.
+ *
+ * return   : drift in ppm, positive when the local clock is slow
+ */
+int32_t I2CDriver::getClockDrift(void) {
+	updateBusClock();
+	return (int32_t) (((int64_t) rateCorrection * 1000000) >> 24);
+}
+#endif
 
-		// initiate the transmission
-		SEND_START_CONDITION();
+#if BOOTLOADER_USAGE == USE_BOOTLOADER && I2C_MODE == MODE_SLAVE
+/**
+ * Don't acknowledge the address of the slave while busy, the master gets a
+ * NACK and polls the slave. A frame in progress is ended normally.
+ *
+ * busy     : 1 to refuse the next frames, 0 to accept them
+ */
+void I2CDriver::setSlaveBusy(uint8_t busy) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		slaveBusy = busy;
+		if (driverState == I2C_READY) {
+			TWCR = _BV(TWEN) | _BV(TWIE) | (busy ? 0 : _BV(TWEA));
+		}
 	}
-
-	return 0;
 }
 #endif
 
-#if I2C_MODE == MODE_MASTER
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
 /**
- * Received data from a slave define by an address.
+ * Copy registers of the map. A frame of the master is committed in the
+ * interruption of its stop condition, the copy never holds a partial frame.
+ * The registers after the end of the map are not copied.
  *
- * address  : address of a slave
- * data     : Data to send
- * length   : Number of byte to receive
+ * reg      : first register
+ * data     : copy of the registers
+ * length   : number of registers
  */
-uint8_t I2CDriver::readFrom(uint8_t address, uint8_t *data, uint8_t length) {
+void I2CDriver::readRegisters(uint8_t reg, uint8_t *data, uint8_t length) {
+	if (reg >= I2C_REGISTER_MAP_SIZE) {
+		return;
+	}
+	if (length > I2C_REGISTER_MAP_SIZE - reg) {
+		length = I2C_REGISTER_MAP_SIZE - reg;
+	}
 
-	if (driverState == I2C_READY) {
-		uint8_t i;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memcpy(data, &registerMap[reg], length);
+	}
+}
 
-		typeOfCommunication = MASTER_RECEIVED;
-		driverState = I2C_MASTER_TRANSMIT;
+/**
+ * Update registers of the map, a read of the master gets all of them or
+ * none of them. The registers after the end of the map are not written.
+ *
+ * reg      : first register
+ * data     : new value of the registers
+ * length   : number of registers
+ */
+void I2CDriver::writeRegisters(uint8_t reg, const uint8_t *data, uint8_t length) {
+	if (reg >= I2C_REGISTER_MAP_SIZE) {
+		return;
+	}
+	if (length > I2C_REGISTER_MAP_SIZE - reg) {
+		length = I2C_REGISTER_MAP_SIZE - reg;
+	}
 
-		/* Initialize the data buffer */
-		dataPointer = 0;
-		nbDataToSend = length;
-		masterReceivedBuffer = data;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		memcpy(&registerMap[reg], data, length);
+	}
+}
 
-		/* copy data to send in the buffer */
-		i2cAddress = (address << 1) + 1;
-		i2cBuffer = data;
+/**
+ * Check if the master has written the map since the last call.
+ */
+uint8_t I2CDriver::isRegisterMapChanged(void) {
+	uint8_t changed;
 
-		// initiate the transmission
-		SEND_START_CONDITION();
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		changed = registerMapChanged;
+		registerMapChanged = 0;
 	}
-
-	return 0;
+	return changed;
 }
 #endif
 
@@ -273,11 +1878,53 @@ ISR(TWI_vect) {
 	/* Specific for transmission                                            */
 	/* ******************************************************************** */
 	case MS_STARTBIT_TRANSMITTED_AND_ACK_RECEIVED_18:
+#if TIME_SYNC_USAGE == USE_TIME_SYNC
+		if (timeSyncCapture) {
+			timeSyncCapture = 0;
+			timeSyncMasterTime = I2C_TIME_SYNC_CLOCK();
+		}
+#endif
+		/* falls through */
 	case MS_DATA_TRANSMITTED_ACK_RECEIVED_28:
+#if GATHER_READ_USAGE == USE_GATHER_READ
+		if (typeOfCommunication == MASTER_GATHER) {
+			if (!gatherRegisterSent) {
+				gatherRegisterSent = 1;
+				TWDR = gatherRegister;
+				REQUEST_SEND_WITH_ACK();
+			} else {
+				// Repeated start to read the block
+				i2cAddress |= 1;
+				SEND_START_CONDITION();
+			}
+			break;
+		}
+#endif
+#if SLICING_USAGE == USE_SLICING
+		if (typeOfCommunication == MASTER_SLICE && dataPointer == nbDataToSend) {
+			// Repeated start to read the slice
+			sliceRead();
+			SEND_START_CONDITION();
+			break;
+		}
+#endif
 		if (dataPointer < nbDataToSend) {
 			TWDR = i2cBuffer[dataPointer++];
 			REQUEST_SEND_WITH_ACK();
-		} else {
+		}
+#if STREAM_USAGE == USE_STREAM
+		else if (typeOfCommunication == MASTER_STREAM && streamFraming == STREAM_CONTINUOUS && !streamStopping) {
+			// Wait the next period in the frame
+			streamHeld = 1;
+			HOLD_STREAM();
+		}
+#endif
+		else {
+#if SLICING_USAGE == USE_SLICING
+			if (sliceNext()) {
+				break;
+			}
+#endif
 			SEND_STOP_CONDITION();
 			driverState = I2C_READY;
 		}
@@ -285,14 +1932,36 @@ ISR(TWI_vect) {
 
 		// Interruption due to missing ack on start bit
 	case MS_STARTBIT_TRANSMITTED_AND_NO_ACK_RECEIVED_20: // address sent, nack received
-		lastRequestStatus = I2C_MISSING_ACK;
+		setRequestStatus(I2C_MISSING_ACK);
+#if GATHER_READ_USAGE == USE_GATHER_READ
+		if (typeOfCommunication == MASTER_GATHER) {
+			gatherNextDevice();
+			break;
+		}
+#endif
+#if SLICING_USAGE == USE_SLICING
+		if (sliceNext()) {
+			break;
+		}
+#endif
 		SEND_STOP_CONDITION();
 		driverState = I2C_READY;
 		break;
 
 		// Interruption due to missing ack on data
 	case MS_DATA_TRANSMITTED_NO_ACK_RECEIVED_30: // data sent, nack received
-		lastRequestStatus = I2C_MISSING_ACK;
+		setRequestStatus(I2C_MISSING_ACK);
+#if GATHER_READ_USAGE == USE_GATHER_READ
+		if (typeOfCommunication == MASTER_GATHER) {
+			gatherNextDevice();
+			break;
+		}
+#endif
+#if SLICING_USAGE == USE_SLICING
+		if (sliceNext()) {
+			break;
+		}
+#endif
 		SEND_STOP_CONDITION();
 		driverState = I2C_READY;
 		break;
@@ -302,6 +1971,13 @@ ISR(TWI_vect) {
 	/* Specific for reception                                               */
 	/* ******************************************************************** */
 	case MR_STARTBIT_TRANSMITED_AND_ACK_RECEIVED_40: // address sent, ack received
+#if STREAM_USAGE == USE_STREAM
+		// A continuous frame acknowledges all the bytes
+		if (typeOfCommunication == MASTER_STREAM && streamFraming == STREAM_CONTINUOUS) {
+			REQUEST_SEND_WITH_ACK();
+			break;
+		}
+#endif
 		// ack if more bytes are expected, otherwise nack
 		if (dataPointer < nbDataToSend-1) {
 			REQUEST_SEND_WITH_ACK();
@@ -311,7 +1987,28 @@ ISR(TWI_vect) {
 		break;
 
 	case MR_DATA_RECEIVED_ACK_RETURN_50: // data received, ack sent
-		masterReceivedBuffer[dataPointer++] = TWDR;
+		storeReceivedByte(TWDR);
+#if STREAM_USAGE == USE_STREAM
+		if (typeOfCommunication == MASTER_STREAM && streamFraming == STREAM_CONTINUOUS) {
+			if (dataPointer < nbDataToSend) {
+				REQUEST_SEND_WITH_ACK();
+			} else {
+				streamSampleReceived();
+				if (streamStopping) {
+					// The next byte is not stored, the frame ends with its NACK
+					REQUEST_SEND_WITHOUT_ACK();
+				} else {
+					// Wait the next period in the frame
+					streamHeld = 1;
+					HOLD_STREAM();
+				}
+			}
+			break;
+		}
+#endif
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+		checkEndOfMessage(TWDR);
+#endif
 		if (dataPointer < nbDataToSend-1) {
 			REQUEST_SEND_WITH_ACK();
 		} else {
@@ -320,13 +2017,49 @@ ISR(TWI_vect) {
 		break;
 
 	case MR_DATA_RECEIVED_NO_ACK_RETURN_58: // data received, nack sent
-		// put final byte into buffer
-		masterReceivedBuffer[dataPointer++] = TWDR;
+		// put final byte into buffer, unless it follows the end of the message
+		if (dataPointer < nbDataToSend) {
+			storeReceivedByte(TWDR);
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+			// With a length of 1 the length byte is received with NACK
+			checkEndOfMessage(TWDR);
+#endif
+#if STREAM_USAGE == USE_STREAM
+			if (typeOfCommunication == MASTER_STREAM) {
+				streamSampleReceived();
+			}
+#endif
+		}
+#if GATHER_READ_USAGE == USE_GATHER_READ
+		if (typeOfCommunication == MASTER_GATHER) {
+			// The last byte of the block is received
+			gatherResults[gatherDevice >> 3] |= 1 << (gatherDevice & 7);
+			gatherNextDevice();
+			break;
+		}
+#endif
+#if SLICING_USAGE == USE_SLICING
+		if (sliceNext()) {
+			break;
+		}
+#endif
 		SEND_STOP_CONDITION();
 		driverState = I2C_READY;
 		break;
 
 	case MR_STARTBIT_TRANSMITTED_AND_NO_ACK_RECEIVED_48: // address sent, nack received
+		setRequestStatus(I2C_MISSING_ACK);
+#if GATHER_READ_USAGE == USE_GATHER_READ
+		if (typeOfCommunication == MASTER_GATHER) {
+			gatherNextDevice();
+			break;
+		}
+#endif
+#if SLICING_USAGE == USE_SLICING
+		if (sliceNext()) {
+			break;
+		}
+#endif
 		SEND_STOP_CONDITION();
 		driverState = I2C_READY;
 		break;
@@ -335,7 +2068,18 @@ ISR(TWI_vect) {
 	/* Common for the master interruption                                   */
 	/* ******************************************************************** */
 	case MASTER_ARBITRATION_LOST_38: // lost bus arbitration
-		lastRequestStatus = I2C_LOST_ARBITRATION;
+		setRequestStatus(I2C_LOST_ARBITRATION);
+#if SLICING_USAGE == USE_SLICING
+		// The sliced read and the postponed request are lost with the bus
+		if (sliceActive) {
+			sliceActive = 0;
+			sliceStatus = I2C_LOST_ARBITRATION;
+		}
+		if (slicePending) {
+			slicePending = 0;
+			lastRequestStatus = I2C_LOST_ARBITRATION;
+		}
+#endif
 		twi_releaseBus();
 		break;
 		// No information
@@ -346,7 +2090,12 @@ ISR(TWI_vect) {
 
 		// in case of bus error
 	case COMMON_BUS_EEOR_00: // bus error, illegal stop/start
-		lastRequestStatus = I2C_BUS_ERROR;
+		setRequestStatus(I2C_BUS_ERROR);
+#if SLICING_USAGE == USE_SLICING
+		if (sliceNext()) {
+			break;
+		}
+#endif
 		SEND_STOP_CONDITION();
 		driverState = I2C_READY;
 		break;
@@ -354,6 +2103,15 @@ ISR(TWI_vect) {
 #endif
 
 #if I2C_MODE == MODE_SLAVE
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+	uint8_t interruptStart = I2C_STATISTICS_TIMER;
+	uint8_t interruptTime;
+#endif
+
+#if BRIDGE_USAGE == USE_BRIDGE
+	// The frames of the other addresses of the mask are forwarded by the bridge
+	if (!i2cBridge.interrupt(GET_COMMUNICATION_STATUS()))
+#endif
 	switch (GET_COMMUNICATION_STATUS()) {
 
 	/******************************************************************* */
@@ -368,26 +2126,45 @@ ISR(TWI_vect) {
 		typeOfCommunication = SLAVE_RECEIVED;
 		driverState = I2C_SLAVE_RECEIVE;
 		slaveDataPointer=0;
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+		slaveOverrun = 0;
+#endif
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT || TIME_SYNC_USAGE == USE_TIME_SYNC
+		slaveGeneralCall = (GET_COMMUNICATION_STATUS()) == SR_GENERAL_ADDRESS_RECEIVED_ACK_RETURN_70;
+#endif
+#if TIME_SYNC_USAGE == USE_TIME_SYNC
+		if (slaveGeneralCall) {
+			generalCallTime = I2C_TIME_SYNC_CLOCK();
+		}
+#endif
 		REQUEST_SEND_WITH_ACK();
 		break;
 
 	/** Receive data with ACK */
 	case SR_DATA_RECEIVED_ACK_RETURN_80:
 	case SR_GENERAL_DATA_RECEIVED_ACK_RETURN_90:
-		slaveBuffer[slaveDataPointer++] = TWDR;
+		slaveStoreByte(TWDR);
 		REQUEST_SEND_WITH_ACK();
 		break;
 
 
 	case SR_DATA_RECEIVED_NO_ACK_RETURN_88:
 	case SR_GENERAL_DATA_RECEIVED_NO_ACK_RETURN_98:
-		slaveBuffer[slaveDataPointer++] = TWDR;
+		slaveStoreByte(TWDR);
 		REQUEST_SEND_WITHOUT_ACK();
 		break;
 
 	/* End of reception */
 	case SR_STOP_RECEIVED:
-		slaveReceiveCallBack(slaveBuffer, slaveDataPointer);
+		slaveFrameReceived();
+#if BOOTLOADER_USAGE == USE_BOOTLOADER
+		if (slaveBusy) {
+			// Not addressed until the end of the busy state
+			TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT);
+			driverState = I2C_READY;
+			break;
+		}
+#endif
 		ENABLE_I2C();
 		twi_releaseBus();
 		driverState = I2C_READY;
@@ -400,10 +2177,32 @@ ISR(TWI_vect) {
 	case ST_ARBITRATION_LOST_ACK_RETURN_B0:
 		typeOfCommunication = SLAVE_SEND;
 		driverState = I2C_SLAVE_TRANSMIT;
-		slaveTransmitBuffer = slaveTransmitCallBack();
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+		if (statisticsSelected) {
+			statisticsSelected = 0;
+			statisticsSnapshot = slaveStatistics;
+			slaveTransmitBuffer = (uint8_t*) &statisticsSnapshot;
+			slaveTransmitLength = sizeof(tI2CSlaveStatistics);
+		} else
+#endif
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+		if (registerSelected) {
+			// Snapshot of the registers, the application may update them during the frame
+			slaveTransmitLength = I2C_REGISTER_MAP_SIZE - registerPointer;
+			if (slaveTransmitLength > I2C_BUFFER_SIZE) {
+				slaveTransmitLength = I2C_BUFFER_SIZE;
+			}
+			memcpy(slaveBuffer, &registerMap[registerPointer], slaveTransmitLength);
+			slaveTransmitBuffer = slaveBuffer;
+		} else
+#endif
+		{
+			slaveTransmitBuffer = slaveTransmitCallBack();
+			slaveTransmitLength = nbByteToTransmit;
+		}
 		slaveDataPointer=0;
 		TWDR = slaveTransmitBuffer[slaveDataPointer++];
-		if (slaveDataPointer < nbByteToTransmit) {
+		if (slaveDataPointer < slaveTransmitLength) {
 			REQUEST_SEND_WITH_ACK();
 		} else {
 			REQUEST_SEND_WITHOUT_ACK();
@@ -412,7 +2211,7 @@ ISR(TWI_vect) {
 
 	case ST_DATA_TRANSMIT_ACK_RECEIVED_B8:
 		TWDR = slaveTransmitBuffer[slaveDataPointer++];
-		if (slaveDataPointer < nbByteToTransmit) {
+		if (slaveDataPointer < slaveTransmitLength) {
 			REQUEST_SEND_WITH_ACK();
 		} else {
 			REQUEST_SEND_WITHOUT_ACK();
@@ -421,6 +2220,17 @@ ISR(TWI_vect) {
 
 	case ST_DATA_TRANSMIT_NO_ACK_RECEIVED_C0:
 	case ST_LAST_DATA_TRANSMIT_ACK_RECEIVED_C8:
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+		slaveStatistics.framesSent++;
+		slaveStatistics.bytesSent += slaveDataPointer;
+#endif
+#if BOOTLOADER_USAGE == USE_BOOTLOADER
+		if (slaveBusy) {
+			REQUEST_SEND_WITHOUT_ACK();
+			driverState = I2C_READY;
+			break;
+		}
+#endif
 		REQUEST_SEND_WITH_ACK();
 		driverState = I2C_READY;
 		break;
@@ -430,16 +2240,30 @@ ISR(TWI_vect) {
 	/* Common for the two modes                                          */
 	/******************************************************************* */
 	case COMMON_NO_INFO_F8:
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+		slaveStatistics.noInfoInterrupts++;
+#endif
 		driverState = I2C_READY;
 		break;
 
 	// in case of bus error
 	case COMMON_BUS_EEOR_00: // bus error, illegal stop/start
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+		slaveStatistics.busErrors++;
+#endif
 		lastRequestStatus = I2C_BUS_ERROR;
 		SEND_STOP_CONDITION();
 		driverState = I2C_READY;
 		break;
 	}
+
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+	interruptTime = I2C_STATISTICS_TIMER - interruptStart;
+	if (interruptTime > slaveStatistics.maxInterruptTime) {
+		slaveStatistics.maxInterruptTime = interruptTime;
+	}
+#endif
 #endif
 }
 
+#endif
@@ -1,7 +1,7 @@
 /* ----------------------------------------------------------------------------
   I2CDriver.cpp - I2C driver for the ATMEL TWI Function
   -----------------------------------------------------------------------------
-  Supported processor: ATmega 328P
+  Supported processor: ATmega 328P, megaAVR 0-series
   -----------------------------------------------------------------------------
 
   This library is free software; you can redistribute it and/or
@@ -34,6 +34,13 @@
 #include <inttypes.h>
 #include "I2CDriver_cfg.hpp"
 
+/** Check I2C_CONTROLLER */
+#ifndef I2C_CONTROLLER
+#error I2C_CONTROLLER must be defined
+#elif I2C_CONTROLLER != CONTROLLER_TWI && I2C_CONTROLLER != CONTROLLER_TWI_SMART_MODE
+#error I2C_CONTROLLER must be defined with CONTROLLER_TWI or CONTROLLER_TWI_SMART_MODE
+#endif
+
 /** Check I2C_MODE */
 #ifndef I2C_MODE
 #error I2C_MODE must be defined
@@ -41,6 +48,20 @@
 #error I2C_MODE must be defined with MODE_MASTER or MODE_SLAVE
 #endif
 
+/** Check DUAL_MODE_USAGE */
+#ifndef DUAL_MODE_USAGE
+#error DUAL_MODE_USAGE must be defined
+#elif DUAL_MODE_USAGE != USE_DUAL_MODE && DUAL_MODE_USAGE != DONT_USE_DUAL_MODE
+#error DUAL_MODE_USAGE must be define with USE_DUAL_MODE or DONT_USE_DUAL_MODE
+#elif DUAL_MODE_USAGE == USE_DUAL_MODE
+#if I2C_MODE != MODE_MASTER
+#error The dual mode is only available in master mode
+#endif
+#if I2C_CONTROLLER != CONTROLLER_TWI_SMART_MODE
+#error The dual mode is only available with CONTROLLER_TWI_SMART_MODE
+#endif
+#endif
+
 /** Check speed of I2C */
 #if I2C_MODE == MODE_MASTER
 #ifndef I2C_SPEED
@@ -51,7 +72,7 @@
 #endif
 
 /** Check consistency of the I2C slave address */
-#if I2C_MODE == MODE_SLAVE
+#if I2C_MODE == MODE_SLAVE || DUAL_MODE_USAGE == USE_DUAL_MODE
 #ifndef I2C_ADDRESS
 #error I2C_ADDRESS must be defined
 #else
@@ -80,11 +101,202 @@
 #endif
 #endif
 
+/** Check gather read usage */
+#ifndef GATHER_READ_USAGE
+#error GATHER_READ_USAGE must be defined
+#elif GATHER_READ_USAGE != USE_GATHER_READ && GATHER_READ_USAGE != DONT_USE_GATHER_READ
+#error GATHER_READ_USAGE must be define with USE_GATHER_READ or DONT_USE_GATHER_READ
+#elif GATHER_READ_USAGE == USE_GATHER_READ && I2C_MODE != MODE_MASTER
+#error Gather read is only available in master mode
+#endif
+
+#if GATHER_READ_USAGE == USE_GATHER_READ
+#ifndef I2C_GATHER_MAX_DEVICES
+#error I2C_GATHER_MAX_DEVICES must be defined
+#elif I2C_GATHER_MAX_DEVICES < 1 || I2C_GATHER_MAX_DEVICES > 128
+#error I2C_GATHER_MAX_DEVICES must be defined with a value between 1 and 128
+#endif
+#endif
+
+/** Check address assignment usage */
+#ifndef ADDRESS_ASSIGNMENT_USAGE
+#error ADDRESS_ASSIGNMENT_USAGE must be defined
+#elif ADDRESS_ASSIGNMENT_USAGE != USE_ADDRESS_ASSIGNMENT && ADDRESS_ASSIGNMENT_USAGE != DONT_USE_ADDRESS_ASSIGNMENT
+#error ADDRESS_ASSIGNMENT_USAGE must be define with USE_ADDRESS_ASSIGNMENT or DONT_USE_ADDRESS_ASSIGNMENT
+#elif ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT
+#ifndef I2C_UID_SIZE
+#error I2C_UID_SIZE must be defined
+#elif I2C_UID_SIZE < 1 || I2C_UID_SIZE > 8
+#error I2C_UID_SIZE must be defined with a value between 1 and 8
+#endif
+#if I2C_MODE == MODE_SLAVE
+#ifndef I2C_UID_EEPROM_ADDRESS
+#error I2C_UID_EEPROM_ADDRESS must be defined
+#endif
+#if I2C_UID_SIZE + 2 > I2C_BUFFER_SIZE
+#error I2C_BUFFER_SIZE is too small for the address assignment frames
+#endif
+#endif
+#endif
+
+/** Check predicate read usage */
+#ifndef PREDICATE_READ_USAGE
+#error PREDICATE_READ_USAGE must be defined
+#elif PREDICATE_READ_USAGE != USE_PREDICATE_READ && PREDICATE_READ_USAGE != DONT_USE_PREDICATE_READ
+#error PREDICATE_READ_USAGE must be define with USE_PREDICATE_READ or DONT_USE_PREDICATE_READ
+#elif PREDICATE_READ_USAGE == USE_PREDICATE_READ && I2C_MODE != MODE_MASTER
+#error Predicate read is only available in master mode
+#endif
+
+/** Check slave statistics usage */
+#ifndef SLAVE_STATISTICS_USAGE
+#error SLAVE_STATISTICS_USAGE must be defined
+#elif SLAVE_STATISTICS_USAGE != USE_SLAVE_STATISTICS && SLAVE_STATISTICS_USAGE != DONT_USE_SLAVE_STATISTICS
+#error SLAVE_STATISTICS_USAGE must be define with USE_SLAVE_STATISTICS or DONT_USE_SLAVE_STATISTICS
+#elif SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+#ifndef I2C_STATISTICS_REGISTER
+#error I2C_STATISTICS_REGISTER must be defined
+#endif
+#if I2C_MODE == MODE_SLAVE && !defined(I2C_STATISTICS_TIMER)
+#error I2C_STATISTICS_TIMER must be defined
+#endif
+#if I2C_MODE == MODE_SLAVE && !defined(I2C_STATISTICS_TICK_NS)
+#error I2C_STATISTICS_TICK_NS must be defined
+#endif
+#endif
+
+/** Check time synchronisation usage */
+#ifndef TIME_SYNC_USAGE
+#error TIME_SYNC_USAGE must be defined
+#elif TIME_SYNC_USAGE != USE_TIME_SYNC && TIME_SYNC_USAGE != DONT_USE_TIME_SYNC
+#error TIME_SYNC_USAGE must be define with USE_TIME_SYNC or DONT_USE_TIME_SYNC
+#elif TIME_SYNC_USAGE == USE_TIME_SYNC
+#ifndef I2C_TIME_SYNC_CLOCK
+#error I2C_TIME_SYNC_CLOCK must be defined
+#endif
+#if I2C_MODE == MODE_SLAVE
+#ifndef I2C_TIME_SYNC_LATENCY
+#error I2C_TIME_SYNC_LATENCY must be defined
+#endif
+#if I2C_BUFFER_SIZE < 6
+#error I2C_BUFFER_SIZE is too small for the time synchronisation frames
+#endif
+#endif
+#endif
+
+/** Check bootloader usage */
+#ifndef BOOTLOADER_USAGE
+#error BOOTLOADER_USAGE must be defined
+#elif BOOTLOADER_USAGE != USE_BOOTLOADER && BOOTLOADER_USAGE != DONT_USE_BOOTLOADER
+#error BOOTLOADER_USAGE must be define with USE_BOOTLOADER or DONT_USE_BOOTLOADER
+#endif
+
+/** Check trace usage */
+#ifndef TRACE_USAGE
+#error TRACE_USAGE must be defined
+#elif TRACE_USAGE != USE_TRACE && TRACE_USAGE != DONT_USE_TRACE
+#error TRACE_USAGE must be define with USE_TRACE or DONT_USE_TRACE
+#elif TRACE_USAGE == USE_TRACE
+#if I2C_MODE != MODE_MASTER
+#error The trace is only available in master mode
+#endif
+#ifndef I2C_TRACE_SIZE
+#error I2C_TRACE_SIZE must be defined
+#elif I2C_TRACE_SIZE < 1 || I2C_TRACE_SIZE > 255
+#error I2C_TRACE_SIZE must be defined with a value between 1 and 255
+#endif
+#ifndef I2C_TRACE_CLOCK
+#error I2C_TRACE_CLOCK must be defined
+#endif
+#endif
+
+/** Check register map usage */
+#ifndef REGISTER_MAP_USAGE
+#error REGISTER_MAP_USAGE must be defined
+#elif REGISTER_MAP_USAGE != USE_REGISTER_MAP && REGISTER_MAP_USAGE != DONT_USE_REGISTER_MAP
+#error REGISTER_MAP_USAGE must be define with USE_REGISTER_MAP or DONT_USE_REGISTER_MAP
+#elif REGISTER_MAP_USAGE == USE_REGISTER_MAP
+#if I2C_MODE != MODE_SLAVE
+#error The register map is only available in slave mode
+#endif
+#ifndef I2C_REGISTER_MAP_SIZE
+#error I2C_REGISTER_MAP_SIZE must be defined
+#elif I2C_REGISTER_MAP_SIZE < 1 || I2C_REGISTER_MAP_SIZE > 255
+#error I2C_REGISTER_MAP_SIZE must be defined with a value between 1 and 255
+#endif
+#if I2C_BUFFER_SIZE < 2
+#error I2C_BUFFER_SIZE must be at least 2 to write the register map
+#endif
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS && I2C_STATISTICS_REGISTER < I2C_REGISTER_MAP_SIZE
+#error I2C_STATISTICS_REGISTER must be outside the register map
+#endif
+#endif
+
+/** Check bridge usage */
+#ifndef BRIDGE_USAGE
+#error BRIDGE_USAGE must be defined
+#elif BRIDGE_USAGE != USE_BRIDGE && BRIDGE_USAGE != DONT_USE_BRIDGE
+#error BRIDGE_USAGE must be define with USE_BRIDGE or DONT_USE_BRIDGE
+#elif BRIDGE_USAGE == USE_BRIDGE && I2C_MODE != MODE_SLAVE
+#error The bridge is only available in slave mode
+#endif
+
+/** Check streaming usage */
+#ifndef STREAM_USAGE
+#error STREAM_USAGE must be defined
+#elif STREAM_USAGE != USE_STREAM && STREAM_USAGE != DONT_USE_STREAM
+#error STREAM_USAGE must be define with USE_STREAM or DONT_USE_STREAM
+#elif STREAM_USAGE == USE_STREAM
+#if I2C_MODE != MODE_MASTER
+#error The streaming is only available in master mode
+#endif
+#ifndef I2C_STREAM_SAMPLES
+#error I2C_STREAM_SAMPLES must be defined
+#elif I2C_STREAM_SAMPLES < 2 || I2C_STREAM_SAMPLES > 128 || (I2C_STREAM_SAMPLES & (I2C_STREAM_SAMPLES - 1)) != 0
+#error I2C_STREAM_SAMPLES must be defined with a power of 2 between 2 and 128
+#endif
+#ifndef I2C_STREAM_SAMPLE_SIZE
+#error I2C_STREAM_SAMPLE_SIZE must be defined
+#elif I2C_STREAM_SAMPLE_SIZE < 1 || I2C_STREAM_SAMPLE_SIZE > 255
+#error I2C_STREAM_SAMPLE_SIZE must be defined with a value between 1 and 255
+#endif
+#endif
+
+/** Check slicing usage */
+#ifndef SLICING_USAGE
+#error SLICING_USAGE must be defined
+#elif SLICING_USAGE != USE_SLICING && SLICING_USAGE != DONT_USE_SLICING
+#error SLICING_USAGE must be define with USE_SLICING or DONT_USE_SLICING
+#elif SLICING_USAGE == USE_SLICING
+#if I2C_MODE != MODE_MASTER
+#error The slicing is only available in master mode
+#endif
+#ifndef I2C_SLICE_SIZE
+#error I2C_SLICE_SIZE must be defined
+#elif I2C_SLICE_SIZE < 1 || I2C_SLICE_SIZE > 255
+#error I2C_SLICE_SIZE must be defined with a value between 1 and 255
+#endif
+#endif
+
+/** Check the functions available with the TWI smart mode */
+#if I2C_CONTROLLER == CONTROLLER_TWI_SMART_MODE
+#if GATHER_READ_USAGE == USE_GATHER_READ || ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT \
+		|| PREDICATE_READ_USAGE == USE_PREDICATE_READ || SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS \
+		|| TIME_SYNC_USAGE == USE_TIME_SYNC || BOOTLOADER_USAGE == USE_BOOTLOADER || TRACE_USAGE == USE_TRACE \
+		|| REGISTER_MAP_USAGE == USE_REGISTER_MAP || BRIDGE_USAGE == USE_BRIDGE || STREAM_USAGE == USE_STREAM \
+		|| SLICING_USAGE == USE_SLICING
+#error Gather read, address assignment, predicate read, statistics, time synchronisation, bootloader, trace, register map, bridge, streaming and slicing are only available with CONTROLLER_TWI
+#endif
+#endif
+
 /**
  * Definition of error detection on the I2C Bus
+ *
+ * I2C_MESSAGE_TRUNCATED : the length prefix of a message is larger than the
+ *                         buffer of readLengthPrefixed, the data are clipped
  */
 typedef enum {
-	I2C_OK, I2C_MISSING_ACK, I2C_LOST_ARBITRATION, I2C_BUS_ERROR
+	I2C_OK, I2C_MISSING_ACK, I2C_LOST_ARBITRATION, I2C_BUS_ERROR, I2C_MESSAGE_TRUNCATED
 } tI2CDriverError;
 
 /**
@@ -102,9 +314,51 @@ typedef enum {
  * Definition of the type of communication
  */
 typedef enum {
-	MASTER_SEND, MASTER_RECEIVED, SLAVE_SEND, SLAVE_RECEIVED
+	MASTER_SEND, MASTER_RECEIVED, MASTER_GATHER, MASTER_STREAM, MASTER_SLICE, SLAVE_SEND, SLAVE_RECEIVED
 } tI2CTypeOfCommunication;
 
+#if GATHER_READ_USAGE == USE_GATHER_READ
+/**
+ * Definition of the start of a gather read
+ *
+ * GATHER_STARTED : the sweep is running
+ * GATHER_BUSY    : the driver is busy, a sliced read included
+ * GATHER_INVALID : no slave, too many slaves, a field of 0 byte, a block of
+ *                  more than 255 bytes or a buffer too small
+ */
+typedef enum {
+	GATHER_STARTED, GATHER_BUSY, GATHER_INVALID
+} tI2CGatherStatus;
+#endif
+
+#if STREAM_USAGE == USE_STREAM
+/**
+ * Definition of the direction of a stream
+ */
+typedef enum {
+	STREAM_OUTPUT, STREAM_INPUT
+} tI2CStreamDirection;
+
+/**
+ * Definition of the framing of a stream
+ *
+ * STREAM_FRAMED     : a frame (start, address, sample, stop) per sample
+ * STREAM_CONTINUOUS : one frame, the clock is held low between the samples
+ */
+typedef enum {
+	STREAM_FRAMED, STREAM_CONTINUOUS
+} tI2CStreamFraming;
+#endif
+
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+/**
+ * Definition of the end of a master read
+ */
+typedef enum {
+	READ_FIXED_LENGTH, READ_UNTIL_TERMINATOR, READ_LENGTH_PREFIXED
+} tI2CReadMode;
+#endif
+
 /**
  * Definition of the status code
  *
@@ -155,6 +409,80 @@ typedef enum {
 
 }tI2CStatus;
 
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT
+/**
+ * Definition of the general call commands of the address assignment
+ *
+ * RESET  : [cmd] every slave goes back to its default address
+ * SELECT : [cmd, nbBits, uid] unassigned slaves whose uid starts with the
+ *          nbBits first bits of uid answer the default address, the others
+ *          answer only the general call
+ * ASSIGN : [cmd, uid, address] the slave with this uid takes the address
+ */
+typedef enum {
+	GENERAL_CALL_ADDRESS_RESET = 0xA0,
+	GENERAL_CALL_ADDRESS_SELECT = 0xA1,
+	GENERAL_CALL_ADDRESS_ASSIGN = 0xA2
+} tI2CGeneralCallCommand;
+#endif
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC
+/**
+ * Definition of the general call commands of the time synchronisation
+ *
+ * SYNC      : [cmd, sequence] the master and the slaves read their clock
+ *             at the acknowledge of the general call address
+ * FOLLOW_UP : [cmd, sequence, time] time of the master at the SYNC with
+ *             the same sequence, 4 bytes little endian
+ */
+typedef enum {
+	GENERAL_CALL_TIME_SYNC = 0xB0,
+	GENERAL_CALL_TIME_FOLLOW_UP = 0xB1
+} tI2CTimeSyncCommand;
+#endif
+
+#if TRACE_USAGE == USE_TRACE
+/**
+ * Definition of a request of the trace, 5 bytes in this order
+ */
+typedef struct {
+	/* Time from the previous request in microseconds, in milliseconds when the bit 15 is set */
+	uint16_t interval;
+	/* Address of the slave << 1, the bit 0 is set for a read */
+	uint8_t address;
+	/* Number of bytes of the request */
+	uint8_t length;
+	/* Status of the request, tI2CDriverError */
+	uint8_t status;
+} tI2CTraceRecord;
+#endif
+
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+/**
+ * Definition of the statistics of a slave, sent in this order on the bus.
+ * The counters are little endian and wrap around.
+ */
+typedef struct {
+	/* Frames received, without the selection of the statistics */
+	uint16_t framesReceived;
+	/* Frames transmitted */
+	uint16_t framesSent;
+	/* Bytes received */
+	uint16_t bytesReceived;
+	/* Bytes transmitted */
+	uint16_t bytesSent;
+	/* Bytes dropped because the reception buffer was full */
+	uint16_t overruns;
+	/* Bus errors */
+	uint16_t busErrors;
+	/* Interruptions without relevant state (COMMON_NO_INFO_F8) */
+	uint16_t noInfoInterrupts;
+	/* Longest interruption, in ticks of I2C_STATISTICS_TIMER of the slave (I2C_STATISTICS_TICK_NS),
+	 * measured to one tick, an interruption longer than 255 ticks wraps around */
+	uint8_t maxInterruptTime;
+} tI2CSlaveStatistics;
+#endif
+
 /**
  * I2C driver class.
  *
@@ -167,20 +495,129 @@ public:
 	void initialisation(void);
 	/* Disable the I2C bus */
 	void disable(void);
+	/* Check if the driver is ready for a new request */
+	uint8_t isReady(void);
 
 #if I2C_MODE == MODE_MASTER
 	/** Send data to a slave defined by an address */
 	uint8_t sendTo(uint8_t address, uint8_t* data, uint8_t length);
 	/** Read data from a slave defined by an address */
 	uint8_t readFrom(uint8_t address, uint8_t* data, uint8_t length);
+	/** Check if a slave acknowledges its address, wait the end of the check */
+	uint8_t probe(uint8_t address);
+	/** Status of the last request */
+	tI2CDriverError getLastStatus(void);
 #endif
 
-#if I2C_MODE == MODE_SLAVE
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+	/** Read data from a slave until a terminator byte */
+	uint8_t readUntil(uint8_t address, uint8_t* data, uint8_t length, uint8_t terminator);
+	/** Read data from a slave, the first byte is the number of following bytes */
+	uint8_t readLengthPrefixed(uint8_t address, uint8_t* data, uint8_t length);
+	/** Number of bytes received by the last read */
+	uint8_t getReceivedLength(void);
+#endif
+
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS && I2C_MODE == MODE_MASTER
+	/** Read the statistics of a slave, wait the end of the read */
+	tI2CDriverError readStatistics(uint8_t address, tI2CSlaveStatistics* statistics);
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_MASTER
+	/** Give an address to every unassigned slave, return the number of slaves */
+	uint8_t assignAddresses(uint8_t defaultAddress, uint8_t firstAddress, uint8_t lastAddress);
+#endif
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC && I2C_MODE == MODE_MASTER
+	/** Send the time of the master to the slaves, wait the end of the frames */
+	tI2CDriverError sendTimeSync(void);
+#endif
+
+#if TRACE_USAGE == USE_TRACE
+	/** Remove the oldest request of the trace, return 0 if no request is complete */
+	uint8_t getTraceRecord(tI2CTraceRecord* record);
+	/** Number of requests lost because the trace was full */
+	uint16_t getTraceLost(void);
+#endif
+
+#if STREAM_USAGE == USE_STREAM
+	/** Start the transfer of a sample each period, paced by the Timer1 */
+	uint8_t startStream(uint8_t address, tI2CStreamDirection direction, tI2CStreamFraming framing,
+			uint8_t sampleSize, uint16_t periodUs);
+	/** Stop the stream, wait the end of the current frame */
+	void stopStream(void);
+	/** Add a sample to an output stream, return 0 if the buffer is full */
+	uint8_t writeStreamSample(const uint8_t* sample);
+	/** Remove a sample from an input stream, return 0 if the buffer is empty */
+	uint8_t readStreamSample(uint8_t* sample);
+	/** Number of samples in the buffer */
+	uint8_t getStreamCount(void);
+	/** Number of periods without sample to send */
+	uint16_t getStreamUnderruns(void);
+	/** Number of samples lost because the buffer was full or the bus busy */
+	uint16_t getStreamOverruns(void);
+#endif
+
+#if SLICING_USAGE == USE_SLICING
+	/** Read a memory in slices, the requests of the application run between the slices */
+	uint8_t readMemory(uint8_t address, uint16_t memAddress, uint8_t addressSize, uint8_t* data, uint16_t length);
+	/** Check if the sliced read of the memory is complete */
+	uint8_t isMemoryReadDone(void);
+	/** Status of the sliced read of the memory */
+	tI2CDriverError getMemoryReadStatus(void);
+#endif
+
+#if GATHER_READ_USAGE == USE_GATHER_READ
+	/** Read the same register block from several identical slaves */
+	tI2CGatherStatus gatherFrom(const uint8_t* addresses, uint8_t nbDevices, uint8_t reg,
+			const uint8_t* fieldSizes, uint8_t nbFields, uint8_t* data, uint16_t dataSize);
+	/** Bitmap of the slaves whose block was read by the last gather read */
+	const uint8_t* getGatherResults(void);
+#endif
+
+#if I2C_MODE == MODE_SLAVE || DUAL_MODE_USAGE == USE_DUAL_MODE
 	/* Define a callback function for slave reception */
 	void setSlaveReceivedCallback(void (*callBackFunction)(uint8_t *pBuffer, uint8_t size));
 	/* Define a callback function for slave transmission */
 	void setSlaveTransmitCallback(uint8_t* (*callBackFunction)(void),uint8_t size);
 #endif
+
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS && I2C_MODE == MODE_SLAVE
+	/* Copy the statistics of the slave, maxInterruptTime is in ticks of I2C_STATISTICS_TICK_NS */
+	void getStatistics(tI2CSlaveStatistics* statistics);
+#endif
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT && I2C_MODE == MODE_SLAVE
+	/* Check if the master has assigned an address to the slave */
+	uint8_t isAddressAssigned(void);
+	/* Current address of the slave */
+	uint8_t getSlaveAddress(void);
+#endif
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC && I2C_MODE == MODE_SLAVE
+	/* Check if the slave has received the time of the master */
+	uint8_t isTimeSynchronised(void);
+	/* Time of the master in microseconds */
+	uint32_t getBusTime(void);
+	/* Local clock value at a time of the master */
+	uint32_t toLocalTime(uint32_t busTime);
+	/* Drift of the local clock from the clock of the master, in ppm */
+	int32_t getClockDrift(void);
+#endif
+
+#if BOOTLOADER_USAGE == USE_BOOTLOADER && I2C_MODE == MODE_SLAVE
+	/* Don't acknowledge the address of the slave while busy */
+	void setSlaveBusy(uint8_t busy);
+#endif
+
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+	/* Copy registers of the map */
+	void readRegisters(uint8_t reg, uint8_t* data, uint8_t length);
+	/* Update registers of the map */
+	void writeRegisters(uint8_t reg, const uint8_t* data, uint8_t length);
+	/* Check if the master has written the map since the last call */
+	uint8_t isRegisterMapChanged(void);
+#endif
 };
 
 /** Instantiation of the I2C driver */
@@ -3,7 +3,7 @@
   -----------------------------------------------------------------------------
   VERSION : 1.0.0
   -----------------------------------------------------------------------------
-  Supported processor: ATmega 328P
+  Supported processor: ATmega 328P, megaAVR 0-series
   -----------------------------------------------------------------------------
 
   This library is free software; you can redistribute it and/or
@@ -38,19 +38,85 @@
 #define MODE_MASTER         		1
 /* I2C Slave */
 #define MODE_SLAVE          		0
+/* TWI of the ATmega 328P */
+#define CONTROLLER_TWI              0
+/* TWI of the megaAVR 0-series (ATmega 4809) used in smart mode */
+#define CONTROLLER_TWI_SMART_MODE   1
 /* Use pull up on SDA and SCK pins */
 #define USE_PULL_UP                 1
 /* Don't Use pull up on SDA and SCK pins */
 #define DONT_USE_PULL_UP            0
+/* Use gather read of identical devices */
+#define USE_GATHER_READ             1
+/* Don't use gather read of identical devices */
+#define DONT_USE_GATHER_READ        0
+/* Use dynamic address assignment */
+#define USE_ADDRESS_ASSIGNMENT      1
+/* Don't use dynamic address assignment */
+#define DONT_USE_ADDRESS_ASSIGNMENT 0
+/* Use reads terminated by the data */
+#define USE_PREDICATE_READ          1
+/* Don't use reads terminated by the data */
+#define DONT_USE_PREDICATE_READ     0
+/* Use the write-behind cache of an external EEPROM */
+#define USE_EEPROM_CACHE            1
+/* Don't use the write-behind cache of an external EEPROM */
+#define DONT_USE_EEPROM_CACHE       0
+/* Use the key-value store in the external EEPROM */
+#define USE_KEY_VALUE_STORE         1
+/* Don't use the key-value store in the external EEPROM */
+#define DONT_USE_KEY_VALUE_STORE    0
+/* Use the statistics of the slave readable on the bus */
+#define USE_SLAVE_STATISTICS        1
+/* Don't use the statistics of the slave readable on the bus */
+#define DONT_USE_SLAVE_STATISTICS   0
+/* Use the synchronisation of the time of the slaves */
+#define USE_TIME_SYNC               1
+/* Don't use the synchronisation of the time of the slaves */
+#define DONT_USE_TIME_SYNC          0
+/* Use the bootloader over I2C */
+#define USE_BOOTLOADER              1
+/* Don't use the bootloader over I2C */
+#define DONT_USE_BOOTLOADER         0
+/* Use the trace of the requests of the master */
+#define USE_TRACE                   1
+/* Don't use the trace of the requests of the master */
+#define DONT_USE_TRACE              0
+/* Use the register map of the slave */
+#define USE_REGISTER_MAP            1
+/* Don't use the register map of the slave */
+#define DONT_USE_REGISTER_MAP       0
+/* Use the bridge to a downstream bus */
+#define USE_BRIDGE                  1
+/* Don't use the bridge to a downstream bus */
+#define DONT_USE_BRIDGE             0
+/* Use the timer-paced streaming of samples */
+#define USE_STREAM                  1
+/* Don't use the timer-paced streaming of samples */
+#define DONT_USE_STREAM             0
+/* Slice the long reads of memories */
+#define USE_SLICING                 1
+/* Don't slice the long reads of memories */
+#define DONT_USE_SLICING            0
+/* Use the client of the TWI0 together with the host */
+#define USE_DUAL_MODE               1
+/* Don't use the client of the TWI0 together with the host */
+#define DONT_USE_DUAL_MODE          0
 
 
+/* I2C_CONTROLLER must be defined with CONTROLLER_TWI or CONTROLLER_TWI_SMART_MODE */
+#define I2C_CONTROLLER				CONTROLLER_TWI
+
 /* I2C_MODE must be defined with MODE_MASTER or MODE_SLAVE */
 #define I2C_MODE 					NOT_DEFINED
 
 /* I2C_SPEED must be defined with a value lower than 400000L */
 #define I2C_SPEED					NOT_DEFINED
 
-#if I2C_MODE == MODE_SLAVE
+/* Define if the client answers I2C_ADDRESS while the host runs USE_DUAL_MODE or not DONT_USE_DUAL_MODE (master with CONTROLLER_TWI_SMART_MODE only) */
+#define DUAL_MODE_USAGE				DONT_USE_DUAL_MODE
+
+#if I2C_MODE == MODE_SLAVE || DUAL_MODE_USAGE == USE_DUAL_MODE
 	#define I2C_ADDRESS  			NOT_DEFINED
 #endif
 
@@ -60,4 +126,157 @@
 /* I2C_BUFFER_SIZE must be defined with a value */
 #define I2C_BUFFER_SIZE				NOT_DEFINED
 
+/* Define if gather read must be used USE_GATHER_READ or not DONT_USE_GATHER_READ (master only) */
+#define GATHER_READ_USAGE			DONT_USE_GATHER_READ
+
+#if GATHER_READ_USAGE == USE_GATHER_READ
+	/* Maximum number of slaves of a gather read, 1 bit of result per slave */
+	#define I2C_GATHER_MAX_DEVICES		32
+#endif
+
+/* Define if dynamic address assignment must be used USE_ADDRESS_ASSIGNMENT or not DONT_USE_ADDRESS_ASSIGNMENT
+ * With address assignment, I2C_ADDRESS is the default address of an unassigned slave */
+#define ADDRESS_ASSIGNMENT_USAGE	DONT_USE_ADDRESS_ASSIGNMENT
+
+#if ADDRESS_ASSIGNMENT_USAGE == USE_ADDRESS_ASSIGNMENT
+	/* Size in bytes of the unique ID of a slave */
+	#define I2C_UID_SIZE			4
+	#if I2C_MODE == MODE_SLAVE
+		/* Location of the unique ID in the internal EEPROM */
+		#define I2C_UID_EEPROM_ADDRESS	0
+	#endif
+#endif
+
+/* Define if reads terminated by the data must be used USE_PREDICATE_READ or not DONT_USE_PREDICATE_READ (master only) */
+#define PREDICATE_READ_USAGE		DONT_USE_PREDICATE_READ
+
+/* Define if the EEPROM cache must be used USE_EEPROM_CACHE or not DONT_USE_EEPROM_CACHE (master only) */
+#define EEPROM_CACHE_USAGE			DONT_USE_EEPROM_CACHE
+
+#if EEPROM_CACHE_USAGE == USE_EEPROM_CACHE
+	/* Address of the external EEPROM */
+	#define I2C_EEPROM_DEVICE_ADDRESS	0x50
+	/* Size of a page of the EEPROM */
+	#define I2C_EEPROM_PAGE_SIZE		32
+	/* Size of the memory address: 1 (24C01 to 24C16) or 2 (24C32 and more) */
+	#define I2C_EEPROM_ADDRESS_SIZE		2
+	/* Size of one EEPROM in bytes */
+	#define I2C_EEPROM_DEVICE_SIZE		32768UL
+	/* Number of pages kept in RAM */
+	#define I2C_EEPROM_CACHE_PAGES		4
+	/* Number of EEPROM at I2C_EEPROM_DEVICE_ADDRESS + i, the pages are striped across them */
+	#define I2C_EEPROM_NB_DEVICES		1
+#endif
+
+/* Define if the key-value store must be used USE_KEY_VALUE_STORE or not DONT_USE_KEY_VALUE_STORE (needs the EEPROM cache) */
+#define KEY_VALUE_STORE_USAGE		DONT_USE_KEY_VALUE_STORE
+
+#if KEY_VALUE_STORE_USAGE == USE_KEY_VALUE_STORE
+	/* First address of the store in the EEPROM */
+	#define I2C_KV_START_ADDRESS		0
+	/* Size of a segment of the log, multiple of I2C_EEPROM_PAGE_SIZE */
+	#define I2C_KV_SEGMENT_SIZE			256
+	/* Number of segments of the log */
+	#define I2C_KV_NB_SEGMENTS			8
+	/* Number of keys, the keys are 0 to I2C_KV_NB_KEYS - 1 */
+	#define I2C_KV_NB_KEYS				32
+	/* Maximal size of a value */
+	#define I2C_KV_MAX_VALUE_SIZE		32
+#endif
+
+/* Define if the statistics of the slaves must be used USE_SLAVE_STATISTICS or not DONT_USE_SLAVE_STATISTICS */
+#define SLAVE_STATISTICS_USAGE		DONT_USE_SLAVE_STATISTICS
+
+#if SLAVE_STATISTICS_USAGE == USE_SLAVE_STATISTICS
+	/* Register written by the master to select the statistics of a slave */
+	#define I2C_STATISTICS_REGISTER		0xF0
+	#if I2C_MODE == MODE_SLAVE
+		/* Free running 8 bits counter used to measure the interruption time */
+		#define I2C_STATISTICS_TIMER		TCNT0
+		/* Duration of a tick of I2C_STATISTICS_TIMER in nanoseconds, TCNT0 has the prescaler 64 of the Arduino core */
+		#define I2C_STATISTICS_TICK_NS		(64000000UL / (F_CPU / 1000UL))
+	#endif
+#endif
+
+/* Define if the time synchronisation must be used USE_TIME_SYNC or not DONT_USE_TIME_SYNC */
+#define TIME_SYNC_USAGE				DONT_USE_TIME_SYNC
+
+#if TIME_SYNC_USAGE == USE_TIME_SYNC
+	/* Local clock in microseconds (uint32_t), read in the interruption */
+	#define I2C_TIME_SYNC_CLOCK()		micros()
+	#if I2C_MODE == MODE_SLAVE
+		/* Microseconds added to the time of the master (difference of the interruption latencies) */
+		#define I2C_TIME_SYNC_LATENCY	0
+	#endif
+#endif
+
+/* Define if the bootloader must be used USE_BOOTLOADER or not DONT_USE_BOOTLOADER */
+#define BOOTLOADER_USAGE			DONT_USE_BOOTLOADER
+
+#if BOOTLOADER_USAGE == USE_BOOTLOADER
+	/* Size of a flash page of the slave (SPM_PAGESIZE) */
+	#define I2C_BOOT_PAGE_SIZE			128
+	/* Number of bytes of a page sent in a frame, at most I2C_BUFFER_SIZE - 4 on the slave */
+	#define I2C_BOOT_CHUNK_SIZE			16
+	#if I2C_MODE == MODE_SLAVE
+		/* Byte address of the boot section, the pages from this address are not written */
+		#define I2C_BOOT_SECTION_START		0x7000
+	#endif
+#endif
+
+/* Define if the trace of the requests must be used USE_TRACE or not DONT_USE_TRACE (master only) */
+#define TRACE_USAGE					DONT_USE_TRACE
+
+#if TRACE_USAGE == USE_TRACE
+	/* Number of requests kept in the trace */
+	#define I2C_TRACE_SIZE				64
+	/* Clock in microseconds (uint32_t) */
+	#define I2C_TRACE_CLOCK()			micros()
+#endif
+
+/* Define if the register map must be used USE_REGISTER_MAP or not DONT_USE_REGISTER_MAP (slave only) */
+#define REGISTER_MAP_USAGE			DONT_USE_REGISTER_MAP
+
+#if REGISTER_MAP_USAGE == USE_REGISTER_MAP
+	/* Number of registers of the map, from the register 0 */
+	#define I2C_REGISTER_MAP_SIZE		32
+#endif
+
+/* Define if the bridge to a downstream bus must be used USE_BRIDGE or not DONT_USE_BRIDGE (slave only) */
+#define BRIDGE_USAGE				DONT_USE_BRIDGE
+
+#if BRIDGE_USAGE == USE_BRIDGE
+	/* Bits of the address ignored by the TWI (TWAMR), the addresses which only differ from I2C_ADDRESS by these bits are forwarded */
+	#define I2C_BRIDGE_ADDRESS_MASK		0x07
+	/* Pins of the downstream bus, external pull-up resistors are needed */
+	#define I2C_BRIDGE_DDR				DDRD
+	#define I2C_BRIDGE_PORT				PORTD
+	#define I2C_BRIDGE_PIN				PIND
+	#define I2C_BRIDGE_SDA				PD2
+	#define I2C_BRIDGE_SCL				PD3
+	/* Half period of the downstream clock in microseconds, 5 for about 100 kHz */
+	#define I2C_BRIDGE_HALF_BIT_US		5
+	/* Number of static registers cached, and their maximum size */
+	#define I2C_BRIDGE_CACHE_ENTRIES	4
+	#define I2C_BRIDGE_CACHE_SIZE		8
+#endif
+
+/* Define if the streaming of samples must be used USE_STREAM or not DONT_USE_STREAM (master only, uses the Timer1) */
+#define STREAM_USAGE				DONT_USE_STREAM
+
+#if STREAM_USAGE == USE_STREAM
+	/* Number of samples of the ring buffer, a power of 2 up to 128 */
+	#define I2C_STREAM_SAMPLES			32
+	/* Maximum number of bytes of a sample */
+	#define I2C_STREAM_SAMPLE_SIZE		4
+#endif
+
+/* Define if the long reads of memories must be sliced USE_SLICING or not DONT_USE_SLICING (master only) */
+#define SLICING_USAGE				DONT_USE_SLICING
+
+#if SLICING_USAGE == USE_SLICING
+	/* Maximum number of bytes read by a slice, a request of the application waits at most one slice */
+	#define I2C_SLICE_SIZE				16
+#endif
+
 #endif /* I2CDRIVER_CFG_HPP_ */
@@ -0,0 +1,408 @@
+/* ----------------------------------------------------------------------------
+  I2CDriver_megaAVR.cpp - I2C driver for the megaAVR 0-series TWI Function
+  -----------------------------------------------------------------------------
+  Supported processor: megaAVR 0-series (ATmega 4809)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include "I2CDriver.hpp"
+
+#if I2C_CONTROLLER == CONTROLLER_TWI_SMART_MODE
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/* Manage SDA (PA2) and SCL (PA3) internal pull-up resistor */
+#define SET_PULLUP_SDA_SCL()			PORTA.PIN2CTRL |= PORT_PULLUPEN_bm; PORTA.PIN3CTRL |= PORT_PULLUPEN_bm
+#define REMOVE_PULLUP_SDA_SCL()			PORTA.PIN2CTRL &= ~PORT_PULLUPEN_bm; PORTA.PIN3CTRL &= ~PORT_PULLUPEN_bm
+
+/** The client is used by a slave, and by a master in dual mode */
+#define CLIENT_USED						(I2C_MODE == MODE_SLAVE || DUAL_MODE_USAGE == USE_DUAL_MODE)
+
+#if I2C_MODE == MODE_MASTER
+/** Compute MBAUD value for the expected I2C frequency, the rise time is neglected */
+#define FREQUENCY_REGISTER_VALUE() 		((F_CPU / I2C_SPEED) - 10) / 2
+
+/* Enable the host
+ * 	RIEN = Enable read interrupt
+ * 	WIEN = Enable write interrupt
+ * 	SMEN = Smart mode, reading MDATA sends ACKACT and receives the next byte
+ */
+#define ENABLE_HOST()					TWI0.MCTRLA = TWI_RIEN_bm | TWI_WIEN_bm | TWI_SMEN_bm | TWI_ENABLE_bm
+
+/** Force the state of the bus to idle */
+#define SET_BUS_IDLE()					TWI0.MSTATUS = TWI_BUSSTATE_IDLE_gc
+
+/** Send a stop condition on the bus */
+#define SEND_STOP_CONDITION()			TWI0.MCTRLB = TWI_ACKACT_NACK_gc | TWI_MCMD_STOP_gc
+
+/** Acknowledge the next received bytes */
+#define SET_ACK()						TWI0.MCTRLB = TWI_ACKACT_ACK_gc
+
+/** Don't acknowledge the next received byte */
+#define SET_NACK()						TWI0.MCTRLB = TWI_ACKACT_NACK_gc
+
+/** Clear the error flags */
+#define CLEAR_HOST_ERRORS()				TWI0.MSTATUS = TWI_ARBLOST_bm | TWI_BUSERR_bm
+#endif
+
+#if CLIENT_USED
+/* Enable the client
+ * 	DIEN  = Enable data interrupt
+ * 	APIEN = Enable address or stop interrupt
+ * 	PIEN  = Enable stop interrupt
+ * 	SMEN  = Smart mode, reading or writing SDATA sends the response
+ */
+#define ENABLE_CLIENT()					TWI0.SCTRLA = TWI_DIEN_bm | TWI_APIEN_bm | TWI_PIEN_bm | TWI_SMEN_bm | TWI_ENABLE_bm
+
+/** Acknowledge the address or the next received byte */
+#define SEND_RESPONSE_WITH_ACK()		TWI0.SCTRLB = TWI_ACKACT_ACK_gc | TWI_SCMD_RESPONSE_gc
+
+/** Don't acknowledge the next received byte */
+#define SET_CLIENT_NACK()				TWI0.SCTRLB = TWI_ACKACT_NACK_gc
+
+/** End of the transaction, wait the next start condition */
+#define COMPLETE_TRANSACTION()			TWI0.SCTRLB = TWI_SCMD_COMPTRANS_gc
+
+/** Clear the error flags */
+#define CLEAR_CLIENT_ERRORS()			TWI0.SSTATUS = TWI_COLL_bm | TWI_BUSERR_bm
+#endif
+
+#if I2C_MODE == MODE_MASTER
+/** Type of communication of the host */
+static tI2CTypeOfCommunication typeOfCommunication;
+
+/** Status on the host */
+static volatile tI2CDriverState driverState;
+
+/* STatus of the last reception or transmission */
+static volatile tI2CDriverError lastRequestStatus;
+
+/** Pointer on the data buffer to transmit or receive */
+static uint8_t *i2cBuffer;
+
+/** Pointer on the current data in the data buffer */
+static uint8_t dataPointer;
+
+/** Number of data to send */
+static uint8_t nbDataToSend;
+#endif
+
+#if CLIENT_USED
+/** Type of communication of the client, independent of the host in dual mode */
+static tI2CTypeOfCommunication clientCommunication;
+
+/** Status on the client */
+static volatile tI2CDriverState clientState;
+
+static uint8_t slaveDataPointer;
+static uint8_t slaveBuffer[I2C_BUFFER_SIZE];
+static uint8_t * slaveTransmitBuffer;
+static uint8_t nbByteToTransmit;
+static uint8_t * (*slaveTransmitCallBack)(void);
+static void (*slaveReceiveCallBack)(uint8_t *prtBuffer, uint8_t nbBytes);
+#endif
+
+/* Instantiation of the I2C driver */
+I2CDriver i2cDriver;
+
+/**
+ * Initialization of the I2C driver.
+ */
+void I2CDriver::initialisation(void) {
+#if PULL_UP_USAGE == USE_PULL_UP
+	SET_PULLUP_SDA_SCL();
+#endif
+
+#if I2C_MODE == MODE_MASTER
+	driverState = I2C_READY;
+
+	// Set I2C frequency
+	TWI0.MBAUD = FREQUENCY_REGISTER_VALUE();
+
+	// Activate the I2C
+	ENABLE_HOST();
+	SET_BUS_IDLE();
+#endif
+
+#if CLIENT_USED
+	// In dual mode the client shares SDA and SCL with the host
+	clientState = I2C_READY;
+	TWI0.SADDR = I2C_ADDRESS << 1;
+
+	// Activate the I2C
+	ENABLE_CLIENT();
+#endif
+}
+
+/**
+ * Disable the I2C bus
+ */
+void I2CDriver::disable() {
+#if I2C_MODE == MODE_MASTER
+	TWI0.MCTRLA = 0;
+#endif
+#if CLIENT_USED
+	TWI0.SCTRLA = 0;
+#endif
+
+	// deactivate internal pullups for twi.
+	REMOVE_PULLUP_SDA_SCL();
+}
+
+/**
+ * Check if the driver is ready for a new request.
+ * In dual mode, only the host is checked.
+ *
+ * return   : 1 if no transfer is running, 0 otherwise
+ */
+uint8_t I2CDriver::isReady(void) {
+#if I2C_MODE == MODE_MASTER
+	return driverState == I2C_READY;
+#else
+	return clientState == I2C_READY;
+#endif
+}
+
+#if I2C_MODE == MODE_MASTER
+/**
+ * Send data to a slave define by an address.
+ *
+ * address  : address of a slave
+ * data     : Data to send
+ * length   : Number of byte to send
+ */
+uint8_t I2CDriver::sendTo(uint8_t address, uint8_t *data, uint8_t length) {
+	if (driverState == I2C_READY) {
+		typeOfCommunication = MASTER_SEND;
+		driverState = I2C_MASTER_TRANSMIT;
+		lastRequestStatus = I2C_OK;
+
+		/* Initialize the data buffer */
+		dataPointer = 0;
+		nbDataToSend = length;
+		i2cBuffer = data;
+
+		// Start condition and address, the write interrupt follows the ACK
+		TWI0.MADDR = address << 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Received data from a slave define by an address.
+ *
+ * address  : address of a slave
+ * data     : Data to send
+ * length   : Number of byte to receive, at least 1
+ */
+uint8_t I2CDriver::readFrom(uint8_t address, uint8_t *data, uint8_t length) {
+	if (driverState == I2C_READY) {
+		typeOfCommunication = MASTER_RECEIVED;
+		driverState = I2C_MASTER_RECEIVE;
+		lastRequestStatus = I2C_OK;
+
+		/* Initialize the data buffer */
+		dataPointer = 0;
+		nbDataToSend = length;
+		i2cBuffer = data;
+
+		// Start condition and address, the read interrupt follows the first byte
+		SET_ACK();
+		TWI0.MADDR = (address << 1) + 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Check if a slave acknowledges its address.
+ * Wait the end of the current request, then send an empty write.
+ *
+ * address  : address of a slave
+ * return   : 1 if the slave acknowledges, 0 otherwise
+ */
+uint8_t I2CDriver::probe(uint8_t address) {
+	while (driverState != I2C_READY)
+		;
+	sendTo(address, 0, 0);
+	while (driverState != I2C_READY)
+		;
+
+	return lastRequestStatus == I2C_OK;
+}
+
+/**
+ * Status of the last request.
+ */
+tI2CDriverError I2CDriver::getLastStatus(void) {
+	return lastRequestStatus;
+}
+
+/**
+ * Interruption function of the host.
+ * In smart mode the read of MDATA sends the ACK or NACK prepared in MCTRLB
+ * and starts the reception of the next byte, without other access.
+ */
+ISR(TWI0_TWIM_vect) {
+	uint8_t status = TWI0.MSTATUS;
+
+	/* ******************************************************************** */
+	/* Lost arbitration and bus error                                       */
+	/* ******************************************************************** */
+	if (status & (TWI_ARBLOST_bm | TWI_BUSERR_bm)) {
+		lastRequestStatus = (status & TWI_ARBLOST_bm) ? I2C_LOST_ARBITRATION : I2C_BUS_ERROR;
+		CLEAR_HOST_ERRORS();
+		SET_BUS_IDLE();
+		driverState = I2C_READY;
+
+	/* ******************************************************************** */
+	/* Address or data transmitted                                          */
+	/* ******************************************************************** */
+	} else if (status & TWI_WIF_bm) {
+		if (status & TWI_RXACK_bm) {
+			// Missing ack on the address (write or read) or on data
+			lastRequestStatus = I2C_MISSING_ACK;
+			SEND_STOP_CONDITION();
+			driverState = I2C_READY;
+		} else if (typeOfCommunication == MASTER_SEND && dataPointer < nbDataToSend) {
+			// Writing MDATA sends the byte
+			TWI0.MDATA = i2cBuffer[dataPointer++];
+		} else {
+			SEND_STOP_CONDITION();
+			driverState = I2C_READY;
+		}
+
+	/* ******************************************************************** */
+	/* Data received                                                        */
+	/* ******************************************************************** */
+	} else if (status & TWI_RIF_bm) {
+		uint8_t data;
+
+		if (dataPointer < nbDataToSend - 1) {
+			// ACK sent and next byte received by the read of MDATA
+			i2cBuffer[dataPointer++] = TWI0.MDATA;
+		} else {
+			// NACK sent by the read of MDATA, then stop
+			SET_NACK();
+			data = TWI0.MDATA;
+			if (dataPointer < nbDataToSend) {
+				i2cBuffer[dataPointer++] = data;
+			}
+			SEND_STOP_CONDITION();
+			driverState = I2C_READY;
+		}
+	}
+}
+#endif
+
+#if CLIENT_USED
+void I2CDriver::setSlaveReceivedCallback(void (* callBackFunction)(uint8_t* pBuffer, uint8_t size))
+{
+	slaveReceiveCallBack = callBackFunction;
+}
+
+void I2CDriver::setSlaveTransmitCallback(uint8_t * (* callBackFunction)(void), uint8_t size)
+{
+	slaveTransmitCallBack = callBackFunction;
+	nbByteToTransmit = size;
+}
+
+/**
+ * Interruption function of the client.
+ * In smart mode the read or the write of SDATA sends the response.
+ * In dual mode, the client runs while the host waits or transfers with
+ * other slaves, its state is separate from the state of the host.
+ */
+ISR(TWI0_TWIS_vect) {
+	uint8_t status = TWI0.SSTATUS;
+
+	/******************************************************************* */
+	/* Collision and bus error                                           */
+	/******************************************************************* */
+	if (status & (TWI_COLL_bm | TWI_BUSERR_bm)) {
+		CLEAR_CLIENT_ERRORS();
+		COMPLETE_TRANSACTION();
+		clientState = I2C_READY;
+
+	/******************************************************************* */
+	/* Address received                                                  */
+	/******************************************************************* */
+	} else if ((status & TWI_APIF_bm) && (status & TWI_AP_bm)) {
+		slaveDataPointer = 0;
+		if (status & TWI_DIR_bm) {
+			clientCommunication = SLAVE_SEND;
+			clientState = I2C_SLAVE_TRANSMIT;
+			slaveTransmitBuffer = slaveTransmitCallBack();
+		} else {
+			clientCommunication = SLAVE_RECEIVED;
+			clientState = I2C_SLAVE_RECEIVE;
+		}
+		SEND_RESPONSE_WITH_ACK();
+
+	/******************************************************************* */
+	/* Stop received                                                     */
+	/******************************************************************* */
+	} else if (status & TWI_APIF_bm) {
+		// An empty write is a probe of the master, it carries no message
+		if (clientCommunication == SLAVE_RECEIVED && slaveDataPointer > 0) {
+			slaveReceiveCallBack(slaveBuffer, slaveDataPointer);
+		}
+		COMPLETE_TRANSACTION();
+		clientState = I2C_READY;
+
+	/******************************************************************* */
+	/* Case of the SLAVE Transmit DATA                                   */
+	/******************************************************************* */
+	} else if ((status & TWI_DIF_bm) && (status & TWI_DIR_bm)) {
+		if (slaveDataPointer > 0 && (status & TWI_RXACK_bm)) {
+			// The master does not want more data
+			COMPLETE_TRANSACTION();
+			clientState = I2C_READY;
+		} else if (slaveDataPointer < nbByteToTransmit) {
+			TWI0.SDATA = slaveTransmitBuffer[slaveDataPointer++];
+		} else {
+			TWI0.SDATA = 0xFF;
+		}
+
+	/******************************************************************* */
+	/* Case of the SLAVE Receive DATA                                    */
+	/******************************************************************* */
+	} else if (status & TWI_DIF_bm) {
+		uint8_t data;
+
+		if (slaveDataPointer < I2C_BUFFER_SIZE) {
+			// ACK sent by the read of SDATA
+			slaveBuffer[slaveDataPointer++] = TWI0.SDATA;
+		} else {
+			// The buffer is full, the byte is dropped and not acknowledged
+			SET_CLIENT_NACK();
+			data = TWI0.SDATA;
+			(void) data;
+		}
+	}
+}
+#endif
+
+#endif
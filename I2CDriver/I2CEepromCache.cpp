@@ -0,0 +1,523 @@
+/* ----------------------------------------------------------------------------
+  I2CEepromCache.cpp - Write-behind cache of an external I2C EEPROM
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include "I2CEepromCache.hpp"
+
+#if EEPROM_CACHE_USAGE == USE_EEPROM_CACHE
+
+#include <string.h>
+
+/** Page number of a free line */
+#define NO_PAGE							0xFFFF
+
+/** Number of polls of a busy EEPROM before it is considered absent */
+#define MAX_BUSY_POLLING				255
+
+/**
+ * Definition of a line of the cache
+ */
+typedef struct {
+	/* Page of the EEPROM kept in the line, NO_PAGE if the line is free */
+	uint16_t page;
+	/* First byte of the page held in data */
+	uint8_t validFirst;
+	/* Byte after the last byte of the page held in data, the bytes around are only in the EEPROM */
+	uint8_t validEnd;
+	/* First byte not written to the EEPROM */
+	uint8_t dirtyFirst;
+	/* Byte after the last byte not written to the EEPROM, 0 if the line is clean */
+	uint8_t dirtyEnd;
+	/* Content of the page */
+	uint8_t data[I2C_EEPROM_PAGE_SIZE];
+} tEepromCacheLine;
+
+/** Lines of the cache */
+static tEepromCacheLine cacheLines[I2C_EEPROM_CACHE_PAGES];
+
+/** Next line to replace */
+static uint8_t victimLine;
+
+/** Next line checked by process */
+static uint8_t flushLine;
+
+/** EEPROM written by process, which may be in their write cycle */
+static uint8_t devicesBusy;
+
+/** Memory address followed by the data of a page write */
+static uint8_t transmitBuffer[I2C_EEPROM_ADDRESS_SIZE + I2C_EEPROM_PAGE_SIZE];
+
+/* Instantiation of the EEPROM cache */
+I2CEepromCache i2cEepromCache;
+
+/*
+ * Function setMemoryAddress
+ * Desc     write the memory address in the header of a request
+ * Input    header  : header of the request
+ *          address : memory address
+ * Output   address of the EEPROM on the bus
+ */
+static uint8_t setMemoryAddress(uint8_t *header, uint32_t address) {
+#if I2C_EEPROM_NB_DEVICES > 1
+	uint16_t page = address / I2C_EEPROM_PAGE_SIZE;
+	// Round robin of the pages across the EEPROM
+	uint16_t deviceAddress = (page / I2C_EEPROM_NB_DEVICES) * I2C_EEPROM_PAGE_SIZE + address % I2C_EEPROM_PAGE_SIZE;
+
+	header[0] = deviceAddress >> 8;
+	header[1] = deviceAddress & 0xFF;
+	return I2C_EEPROM_DEVICE_ADDRESS + page % I2C_EEPROM_NB_DEVICES;
+#elif I2C_EEPROM_ADDRESS_SIZE == 1
+	// The high bits of the memory address select a block of the 24C04 to 24C16
+	header[0] = address & 0xFF;
+	return I2C_EEPROM_DEVICE_ADDRESS | ((address >> 8) & 0x07);
+#else
+	header[0] = address >> 8;
+	header[1] = address & 0xFF;
+	return I2C_EEPROM_DEVICE_ADDRESS;
+#endif
+}
+
+/*
+ * Function waitDriverReady
+ * Desc     wait the end of the current request
+ * Input    none
+ * Output   none
+ */
+static void waitDriverReady(void) {
+	while (!i2cDriver.isReady())
+		;
+}
+
+/*
+ * Function deviceRead
+ * Desc     read data from the EEPROM, wait the end of its write cycle
+ * Input    address    : memory address
+ *          data       : received data
+ *          length     : number of bytes to read
+ *          maxPolling : number of attempts while the EEPROM is in its write cycle
+ * Output   status of the read
+ */
+static tI2CDriverError deviceRead(uint32_t address, uint8_t *data, uint8_t length, uint8_t maxPolling) {
+	uint8_t header[I2C_EEPROM_ADDRESS_SIZE];
+	uint8_t device = setMemoryAddress(header, address);
+	uint8_t polling;
+
+	// The EEPROM does not acknowledge its address during a write cycle
+	for (polling = 0; polling < maxPolling; polling++) {
+		waitDriverReady();
+		i2cDriver.sendTo(device, header, I2C_EEPROM_ADDRESS_SIZE);
+		waitDriverReady();
+		if (i2cDriver.getLastStatus() != I2C_MISSING_ACK) {
+			break;
+		}
+	}
+	if (i2cDriver.getLastStatus() != I2C_OK) {
+		return i2cDriver.getLastStatus();
+	}
+
+	i2cDriver.readFrom(device, data, length);
+	waitDriverReady();
+
+	return i2cDriver.getLastStatus();
+}
+
+/*
+ * Function markDirty
+ * Desc     add bytes of a line to the bytes to write to the EEPROM
+ * Input    line  : line of the cache
+ *          first : first byte
+ *          end   : byte after the last byte
+ * Output   none
+ */
+static void markDirty(tEepromCacheLine *line, uint8_t first, uint8_t end) {
+	if (line->dirtyEnd == 0) {
+		line->dirtyFirst = first;
+		line->dirtyEnd = end;
+	} else {
+		// The valid bytes are contiguous, bytes between the two ranges are rewritten unchanged
+		if (first < line->dirtyFirst) {
+			line->dirtyFirst = first;
+		}
+		if (end > line->dirtyEnd) {
+			line->dirtyEnd = end;
+		}
+	}
+}
+
+/*
+ * Function findLine
+ * Desc     find the line of a page
+ * Input    page : page of the EEPROM
+ * Output   line of the page, 0 if the page is not in the cache
+ */
+static tEepromCacheLine* findLine(uint16_t page) {
+	uint8_t i;
+
+	for (i = 0; i < I2C_EEPROM_CACHE_PAGES; i++) {
+		if (cacheLines[i].page == page) {
+			return &cacheLines[i];
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function findCleanLine
+ * Desc     find a free line, or the next clean line to replace
+ * Input    none
+ * Output   line, 0 if all the lines are dirty
+ */
+static tEepromCacheLine* findCleanLine(void) {
+	uint8_t i;
+
+	for (i = 0; i < I2C_EEPROM_CACHE_PAGES; i++) {
+		tEepromCacheLine *line = &cacheLines[victimLine];
+
+		victimLine = (victimLine + 1) % I2C_EEPROM_CACHE_PAGES;
+		if (line->page == NO_PAGE || line->dirtyEnd == 0) {
+			return line;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function loadLine
+ * Desc     read the bytes of a page which are not in its line, without
+ *          waiting the write cycle of the EEPROM
+ * Input    line : line of the page
+ * Output   I2C_OK, or I2C_MISSING_ACK at once if the EEPROM is in its write
+ *          cycle, the line is unchanged on error
+ */
+static tI2CDriverError loadLine(tEepromCacheLine *line) {
+	uint32_t address = (uint32_t) line->page * I2C_EEPROM_PAGE_SIZE;
+	uint8_t deviceBit = 1 << (line->page % I2C_EEPROM_NB_DEVICES);
+	tI2CDriverError status;
+
+	// An EEPROM written by process is probed once instead of polled
+	if ((devicesBusy & deviceBit) != 0) {
+		uint8_t header[I2C_EEPROM_ADDRESS_SIZE];
+
+		if (!i2cDriver.probe(setMemoryAddress(header, address))) {
+			return I2C_MISSING_ACK;
+		}
+		devicesBusy &= ~deviceBit;
+	}
+
+	// The valid bytes may be dirty, only the bytes around them are read
+	if (line->validFirst > 0) {
+		status = deviceRead(address, line->data, line->validFirst, 1);
+		if (status != I2C_OK) {
+			return status;
+		}
+	}
+	if (line->validEnd < I2C_EEPROM_PAGE_SIZE) {
+		status = deviceRead(address + line->validEnd, &line->data[line->validEnd],
+				I2C_EEPROM_PAGE_SIZE - line->validEnd, 1);
+		if (status != I2C_OK) {
+			return status;
+		}
+	}
+	line->validFirst = 0;
+	line->validEnd = I2C_EEPROM_PAGE_SIZE;
+
+	return I2C_OK;
+}
+
+/*
+ * Function allocateLine
+ * Desc     get the line of a page for a write, a page which is not in the
+ *          cache is not loaded, the line keeps only the written bytes
+ * Input    page  : page of the EEPROM
+ *          first : first byte written
+ *          end   : byte after the last byte written
+ *          line  : line of the page
+ * Output   I2C_OK, or the error of the page write which frees a line or of
+ *          the load of the page, no dirty data is lost
+ */
+static tI2CDriverError allocateLine(uint16_t page, uint8_t first, uint8_t end, tEepromCacheLine **line) {
+	tI2CDriverError status;
+
+	*line = findLine(page);
+	if (*line != 0) {
+		// The valid bytes of a line are contiguous, a write away from them needs the bytes between
+		if (first > (*line)->validEnd || end < (*line)->validFirst) {
+			return loadLine(*line);
+		}
+		return I2C_OK;
+	}
+
+	// All the lines are dirty, one page is written without waiting its write cycle
+	*line = findCleanLine();
+	if (*line == 0) {
+		status = i2cEepromCache.process();
+		*line = findCleanLine();
+		if (*line == 0) {
+			// Page refused by an EEPROM in its write cycle, or driver busy
+			return status != I2C_OK ? status : I2C_MISSING_ACK;
+		}
+	}
+
+	(*line)->page = page;
+	(*line)->validFirst = first;
+	(*line)->validEnd = end;
+	(*line)->dirtyEnd = 0;
+
+	return I2C_OK;
+}
+
+/**
+ * Initialization of the cache, the I2C driver must be initialized.
+ */
+void I2CEepromCache::initialisation(void) {
+	uint8_t i;
+
+	for (i = 0; i < I2C_EEPROM_CACHE_PAGES; i++) {
+		cacheLines[i].page = NO_PAGE;
+		cacheLines[i].dirtyEnd = 0;
+	}
+	victimLine = 0;
+	flushLine = 0;
+	devicesBusy = 0;
+}
+
+/**
+ * Write data at an address of the EEPROM.
+ * The data are written in the cache, a page which is not in the cache is
+ * not loaded. The function waits the bus only to load the bytes between a
+ * write and the bytes already in the cache, or to write one page when all
+ * the pages are dirty, never the write cycle of the EEPROM: an EEPROM in
+ * its write cycle refuses the load or the write with I2C_MISSING_ACK at
+ * once. The data from the failing page are not written, the write must be
+ * done again after process.
+ *
+ * address  : memory address
+ * data     : data to write
+ * length   : number of bytes to write
+ * return   : I2C_OK, or the error of the EEPROM
+ */
+tI2CDriverError I2CEepromCache::write(uint32_t address, const uint8_t *data, uint8_t length) {
+	while (length > 0) {
+		uint8_t offset = address % I2C_EEPROM_PAGE_SIZE;
+		uint8_t size = I2C_EEPROM_PAGE_SIZE - offset;
+		tEepromCacheLine *line;
+		tI2CDriverError status;
+
+		if (size > length) {
+			size = length;
+		}
+
+		status = allocateLine(address / I2C_EEPROM_PAGE_SIZE, offset, offset + size, &line);
+		if (status != I2C_OK) {
+			return status;
+		}
+		memcpy(&line->data[offset], data, size);
+		markDirty(line, offset, offset + size);
+		if (offset < line->validFirst) {
+			line->validFirst = offset;
+		}
+		if (offset + size > line->validEnd) {
+			line->validEnd = offset + size;
+		}
+
+		address += size;
+		data += size;
+		length -= size;
+	}
+
+	return I2C_OK;
+}
+
+/**
+ * Read data at an address of the EEPROM.
+ * The bytes in the cache are read from RAM, the others from the EEPROM.
+ *
+ * address  : memory address
+ * data     : received data
+ * length   : number of bytes to read
+ * return   : status of the read
+ */
+tI2CDriverError I2CEepromCache::read(uint32_t address, uint8_t *data, uint8_t length) {
+	while (length > 0) {
+		uint8_t offset = address % I2C_EEPROM_PAGE_SIZE;
+		uint8_t size = I2C_EEPROM_PAGE_SIZE - offset;
+		tEepromCacheLine *line;
+
+		if (size > length) {
+			size = length;
+		}
+
+		line = findLine(address / I2C_EEPROM_PAGE_SIZE);
+		if (line != 0 && offset >= line->validFirst && offset + size <= line->validEnd) {
+			memcpy(data, &line->data[offset], size);
+		} else {
+			tI2CDriverError status = deviceRead(address, data, size, MAX_BUSY_POLLING);
+			if (status != I2C_OK) {
+				return status;
+			}
+			// The bytes kept in the line are newer than the EEPROM
+			if (line != 0) {
+				uint8_t first = offset > line->validFirst ? offset : line->validFirst;
+				uint8_t end = offset + size < line->validEnd ? offset + size : line->validEnd;
+
+				if (first < end) {
+					memcpy(&data[first - offset], &line->data[first], end - first);
+				}
+			}
+		}
+
+		address += size;
+		data += size;
+		length -= size;
+	}
+
+	return I2C_OK;
+}
+
+/**
+ * Write one dirty page to the EEPROM.
+ * Only the dirty bytes of the page are written. The call is synchronous:
+ * it waits the probes of the busy EEPROM and the transfer of the page on
+ * the bus (about 0.9 ms for 32 bytes at 400 kHz), but not the write cycle
+ * of the EEPROM. A page of an EEPROM in its write cycle is skipped, an
+ * EEPROM written by a previous call is probed before its page is sent. A
+ * page refused by a busy EEPROM stays dirty and is written by a next call.
+ *
+ * return   : status of the page write, I2C_OK if nothing was written,
+ *            I2C_MISSING_ACK if all the dirty pages are in busy EEPROM
+ */
+tI2CDriverError I2CEepromCache::process(void) {
+	uint8_t skipped = 0;
+	uint8_t i;
+
+	if (!i2cDriver.isReady()) {
+		return I2C_OK;
+	}
+
+	for (i = 0; i < I2C_EEPROM_CACHE_PAGES; i++) {
+		tEepromCacheLine *line = &cacheLines[flushLine];
+
+		if (line->dirtyEnd != 0) {
+			uint8_t first = line->dirtyFirst;
+			uint8_t end = line->dirtyEnd;
+			uint8_t device = setMemoryAddress(transmitBuffer,
+					(uint32_t) line->page * I2C_EEPROM_PAGE_SIZE + first);
+			uint8_t deviceBit = 1 << (line->page % I2C_EEPROM_NB_DEVICES);
+
+			// Address ACK probe of an EEPROM which may be in its write cycle
+			if ((devicesBusy & deviceBit) != 0) {
+				if (!i2cDriver.probe(device)) {
+					flushLine = (flushLine + 1) % I2C_EEPROM_CACHE_PAGES;
+					skipped = 1;
+					continue;
+				}
+				devicesBusy &= ~deviceBit;
+			}
+
+			// The memory address and the dirty bytes form the frame of the page write
+			memcpy(&transmitBuffer[I2C_EEPROM_ADDRESS_SIZE], &line->data[first], end - first);
+			line->dirtyEnd = 0;
+
+			i2cDriver.sendTo(device, transmitBuffer, I2C_EEPROM_ADDRESS_SIZE + end - first);
+			waitDriverReady();
+
+			if (i2cDriver.getLastStatus() != I2C_OK) {
+				markDirty(line, first, end);
+				return i2cDriver.getLastStatus();
+			}
+
+			devicesBusy |= deviceBit;
+			flushLine = (flushLine + 1) % I2C_EEPROM_CACHE_PAGES;
+			return I2C_OK;
+		}
+		flushLine = (flushLine + 1) % I2C_EEPROM_CACHE_PAGES;
+	}
+
+	return skipped ? I2C_MISSING_ACK : I2C_OK;
+}
+
+/**
+ * Write all the dirty pages to the EEPROM.
+ *
+ * return   : I2C_OK, or the error of a page write refused too many times
+ */
+tI2CDriverError I2CEepromCache::flush(void) {
+	uint8_t polling = 0;
+
+	while (isDirty()) {
+		tI2CDriverError status = process();
+
+		if (status == I2C_OK) {
+			polling = 0;
+		} else if (++polling == MAX_BUSY_POLLING) {
+			return status;
+		}
+	}
+
+	return I2C_OK;
+}
+
+/**
+ * Write all the dirty pages and wait the end of the EEPROM write cycle.
+ *
+ * return   : I2C_OK, or the error of the EEPROM
+ */
+tI2CDriverError I2CEepromCache::sync(void) {
+	tI2CDriverError status = flush();
+	uint8_t device;
+	uint8_t polling;
+
+	if (status != I2C_OK) {
+		return status;
+	}
+
+	for (device = 0; device < I2C_EEPROM_NB_DEVICES; device++) {
+		for (polling = 0; !i2cDriver.probe(I2C_EEPROM_DEVICE_ADDRESS + device); polling++) {
+			if (polling == MAX_BUSY_POLLING) {
+				return I2C_MISSING_ACK;
+			}
+		}
+	}
+	devicesBusy = 0;
+
+	return I2C_OK;
+}
+
+/**
+ * Check if some pages are not written to the EEPROM.
+ */
+uint8_t I2CEepromCache::isDirty(void) {
+	uint8_t i;
+
+	for (i = 0; i < I2C_EEPROM_CACHE_PAGES; i++) {
+		if (cacheLines[i].dirtyEnd != 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+#endif
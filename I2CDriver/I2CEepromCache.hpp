@@ -0,0 +1,122 @@
+/* ----------------------------------------------------------------------------
+  I2CEepromCache.hpp - Write-behind cache of an external I2C EEPROM
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CEEPROMCACHE_HPP_
+#define I2CEEPROMCACHE_HPP_
+
+#include "I2CDriver.hpp"
+
+/** Check EEPROM cache usage */
+#ifndef EEPROM_CACHE_USAGE
+#error EEPROM_CACHE_USAGE must be defined
+#elif EEPROM_CACHE_USAGE != USE_EEPROM_CACHE && EEPROM_CACHE_USAGE != DONT_USE_EEPROM_CACHE
+#error EEPROM_CACHE_USAGE must be define with USE_EEPROM_CACHE or DONT_USE_EEPROM_CACHE
+#endif
+
+#if EEPROM_CACHE_USAGE == USE_EEPROM_CACHE
+
+/** Check consistency of the EEPROM cache configuration */
+#if I2C_MODE != MODE_MASTER
+#error The EEPROM cache is only available in master mode
+#endif
+#ifndef I2C_EEPROM_DEVICE_ADDRESS
+#error I2C_EEPROM_DEVICE_ADDRESS must be defined
+#elif I2C_EEPROM_DEVICE_ADDRESS > 127
+#error An I2C address > 127 is invalid
+#endif
+#ifndef I2C_EEPROM_PAGE_SIZE
+#error I2C_EEPROM_PAGE_SIZE must be defined
+#elif I2C_EEPROM_PAGE_SIZE < 8 || I2C_EEPROM_PAGE_SIZE > 128
+#error I2C_EEPROM_PAGE_SIZE must be defined with a value between 8 and 128
+#endif
+#ifndef I2C_EEPROM_ADDRESS_SIZE
+#error I2C_EEPROM_ADDRESS_SIZE must be defined
+#elif I2C_EEPROM_ADDRESS_SIZE != 1 && I2C_EEPROM_ADDRESS_SIZE != 2
+#error I2C_EEPROM_ADDRESS_SIZE must be defined with 1 or 2
+#endif
+#ifndef I2C_EEPROM_CACHE_PAGES
+#error I2C_EEPROM_CACHE_PAGES must be defined
+#elif I2C_EEPROM_CACHE_PAGES < 1 || I2C_EEPROM_CACHE_PAGES > 16
+#error I2C_EEPROM_CACHE_PAGES must be defined with a value between 1 and 16
+#endif
+#ifndef I2C_EEPROM_NB_DEVICES
+#error I2C_EEPROM_NB_DEVICES must be defined
+#elif I2C_EEPROM_NB_DEVICES < 1 || I2C_EEPROM_NB_DEVICES > 8
+#error I2C_EEPROM_NB_DEVICES must be defined with a value between 1 and 8
+#elif I2C_EEPROM_NB_DEVICES > 1 && I2C_EEPROM_ADDRESS_SIZE == 1
+#error The block bits of the address of the 24C04 to 24C16 prevent the striping
+#elif I2C_EEPROM_DEVICE_ADDRESS + I2C_EEPROM_NB_DEVICES > 128
+#error The addresses of the EEPROM must be <= 127
+#endif
+#ifndef I2C_EEPROM_DEVICE_SIZE
+#error I2C_EEPROM_DEVICE_SIZE must be defined
+#elif I2C_EEPROM_DEVICE_SIZE % I2C_EEPROM_PAGE_SIZE != 0
+#error I2C_EEPROM_DEVICE_SIZE must be a multiple of I2C_EEPROM_PAGE_SIZE
+#elif I2C_EEPROM_DEVICE_SIZE > (I2C_EEPROM_ADDRESS_SIZE == 1 ? 2048 : 65536)
+#error I2C_EEPROM_DEVICE_SIZE is too big for I2C_EEPROM_ADDRESS_SIZE
+#elif I2C_EEPROM_NB_DEVICES * (I2C_EEPROM_DEVICE_SIZE / I2C_EEPROM_PAGE_SIZE) > 65535
+#error The EEPROM must have less than 65536 pages in total
+#endif
+
+/**
+ * Write-behind cache of an external EEPROM.
+ *
+ * The writes are absorbed in RAM pages, overlapping and adjacent writes of a
+ * page are merged and written to the EEPROM with one page write by process().
+ * A page is not loaded while the writes are contiguous, a write never waits
+ * the write cycle of an EEPROM.
+ * With several EEPROM, the page p is the page p / I2C_EEPROM_NB_DEVICES of
+ * the EEPROM p % I2C_EEPROM_NB_DEVICES: a page is written to an EEPROM while
+ * the others are in their write cycle. The addresses are 32 bits, the address
+ * space is I2C_EEPROM_NB_DEVICES times I2C_EEPROM_DEVICE_SIZE.
+ */
+class I2CEepromCache {
+
+public:
+
+	/* Initialization of the cache, the I2C driver must be initialized */
+	void initialisation(void);
+	/* Write data at an address of the EEPROM */
+	tI2CDriverError write(uint32_t address, const uint8_t* data, uint8_t length);
+	/* Read data at an address of the EEPROM */
+	tI2CDriverError read(uint32_t address, uint8_t* data, uint8_t length);
+	/* Write one dirty page to the EEPROM, must be called periodically */
+	tI2CDriverError process(void);
+	/* Write all the dirty pages to the EEPROM */
+	tI2CDriverError flush(void);
+	/* Write all the dirty pages and wait the end of the EEPROM write cycle */
+	tI2CDriverError sync(void);
+	/* Check if some pages are not written to the EEPROM */
+	uint8_t isDirty(void);
+};
+
+/** Instantiation of the EEPROM cache */
+extern I2CEepromCache i2cEepromCache;
+
+#endif
+
+#endif /* I2CEEPROMCACHE_HPP_ */
@@ -0,0 +1,592 @@
+/* ----------------------------------------------------------------------------
+  I2CKeyValueStore.cpp - Log-structured key-value store in an external EEPROM
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+  -----------------------------------------------------------------------------
+
+  LAYOUT OF A SEGMENT:
+  [sequence high, sequence low] [record] ... [record] [END_OF_SEGMENT]
+
+  The sequence of a free segment is FREE_SEGMENT.
+
+  LAYOUT OF A RECORD:
+  [key] [length] [value, length bytes] [check]
+
+  A record with a length of 0 removes the key.
+
+---------------------------------------------------------------------------- */
+
+#include "I2CKeyValueStore.hpp"
+
+#if KEY_VALUE_STORE_USAGE == USE_KEY_VALUE_STORE
+
+/** Sequence of a free segment, erased EEPROM */
+#define FREE_SEGMENT					0xFFFF
+
+/** Address of a key without record */
+#define NO_RECORD						0xFFFF
+
+/** No segment */
+#define NO_SEGMENT						0xFF
+
+/** Key written after the last record of a segment */
+#define END_OF_SEGMENT					0xFF
+
+/** Size of the header of a segment */
+#define SEGMENT_HEADER_SIZE				2
+
+/** Size of a record without its value */
+#define RECORD_OVERHEAD					3
+
+/** Free segments kept for the compaction */
+#define RESERVED_FREE_SEGMENTS			1
+
+/** Free segments under which compactStep reclaims a segment */
+#define COMPACTION_FREE_SEGMENTS		2
+
+/** Records of the reclaimed segment read by a call of compactStep */
+#define COMPACTION_RECORDS_PER_STEP		2
+
+/** Writes refused by the EEPROM cache before a device error */
+#define MAX_WRITE_RETRIES				255
+
+/**
+ * Definition of an entry of the index
+ */
+typedef struct {
+	/* Address of the last record of the key, NO_RECORD if no record */
+	uint16_t address;
+	/* Length of the value */
+	uint8_t length;
+} tKeyValueIndex;
+
+/** Last record of each key */
+static tKeyValueIndex keyIndex[I2C_KV_NB_KEYS];
+
+/** Sequence of each segment */
+static uint16_t segmentSequence[I2C_KV_NB_SEGMENTS];
+
+/** Segment where the records are appended */
+static uint8_t currentSegment;
+
+/** Offset of the next record in the current segment */
+static uint16_t tailOffset;
+
+/** Sequence of the next opened segment */
+static uint16_t nextSequence;
+
+/** Segment being reclaimed, NO_SEGMENT if none */
+static uint8_t reclaimSegment = NO_SEGMENT;
+
+/** Address of the next record of the reclaimed segment */
+static uint16_t reclaimAddress;
+
+/* Instantiation of the key-value store */
+I2CKeyValueStore i2cKeyValueStore;
+
+/*
+ * Function segmentAddress
+ * Desc     address of a segment in the EEPROM
+ * Input    segment : index of the segment
+ * Output   address of the segment
+ */
+static uint16_t segmentAddress(uint8_t segment) {
+	return I2C_KV_START_ADDRESS + segment * (uint16_t) I2C_KV_SEGMENT_SIZE;
+}
+
+/*
+ * Function isOlder
+ * Desc     compare two sequences, the sequences may wrap
+ * Input    first  : first sequence
+ *          second : second sequence
+ * Output   1 if the first sequence is older
+ */
+static uint8_t isOlder(uint16_t first, uint16_t second) {
+	return (int16_t) (first - second) < 0;
+}
+
+/*
+ * Function freeSegments
+ * Desc     count the free segments
+ * Input    none
+ * Output   number of free segments
+ */
+static uint8_t freeSegments(void) {
+	uint8_t nbFree = 0;
+	uint8_t segment;
+
+	for (segment = 0; segment < I2C_KV_NB_SEGMENTS; segment++) {
+		if (segmentSequence[segment] == FREE_SEGMENT) {
+			nbFree++;
+		}
+	}
+	return nbFree;
+}
+
+/*
+ * Function recordCheck
+ * Desc     compute the check of a record
+ * Input    key    : key of the record
+ *          value  : value of the record
+ *          length : length of the value
+ * Output   check of the record
+ */
+static uint8_t recordCheck(uint8_t key, const uint8_t *value, uint8_t length) {
+	uint8_t check = 0x5A + key + length;
+	uint8_t i;
+
+	for (i = 0; i < length; i++) {
+		check = ((check << 1) | (check >> 7)) + value[i];
+	}
+	return check;
+}
+
+/*
+ * Function storeWrite
+ * Desc     write data in the EEPROM cache, retry while the cache is full
+ *          and the EEPROM in its write cycle
+ * Input    address : memory address
+ *          data    : data to write
+ *          length  : number of bytes to write
+ * Output   KV_OK, or KV_DEVICE_ERROR
+ */
+static tI2CKeyValueStatus storeWrite(uint16_t address, const uint8_t *data, uint8_t length) {
+	uint8_t retries;
+
+	for (retries = 0; retries < MAX_WRITE_RETRIES; retries++) {
+		tI2CDriverError status = i2cEepromCache.write(address, data, length);
+
+		if (status == I2C_OK) {
+			return KV_OK;
+		}
+		if (status != I2C_MISSING_ACK) {
+			break;
+		}
+	}
+	return KV_DEVICE_ERROR;
+}
+
+/*
+ * Function writeSequence
+ * Desc     write the sequence of a segment
+ * Input    segment  : index of the segment
+ *          sequence : sequence of the segment, FREE_SEGMENT to free it
+ * Output   KV_OK, or KV_DEVICE_ERROR
+ */
+static tI2CKeyValueStatus writeSequence(uint8_t segment, uint16_t sequence) {
+	tI2CKeyValueStatus status;
+	uint8_t header[SEGMENT_HEADER_SIZE + 1];
+
+	header[0] = sequence >> 8;
+	header[1] = sequence & 0xFF;
+	header[2] = END_OF_SEGMENT;
+
+	// An opened segment starts empty, old records are behind the end marker
+	status = storeWrite(segmentAddress(segment), header,
+			sequence == FREE_SEGMENT ? SEGMENT_HEADER_SIZE : SEGMENT_HEADER_SIZE + 1);
+	if (status == KV_OK) {
+		segmentSequence[segment] = sequence;
+	}
+	return status;
+}
+
+/*
+ * Function openSegment
+ * Desc     append the records to the next free segment
+ * Input    none
+ * Output   KV_OK, KV_FULL if there is no free segment, or KV_DEVICE_ERROR
+ */
+static tI2CKeyValueStatus openSegment(void) {
+	uint8_t i;
+
+	for (i = 1; i <= I2C_KV_NB_SEGMENTS; i++) {
+		uint8_t segment = (currentSegment + i) % I2C_KV_NB_SEGMENTS;
+
+		if (segmentSequence[segment] == FREE_SEGMENT) {
+			tI2CKeyValueStatus status = writeSequence(segment, nextSequence);
+			if (status != KV_OK) {
+				return status;
+			}
+			if (++nextSequence == FREE_SEGMENT) {
+				nextSequence = 0;
+			}
+			currentSegment = segment;
+			tailOffset = SEGMENT_HEADER_SIZE;
+			return KV_OK;
+		}
+	}
+	return KV_FULL;
+}
+
+/*
+ * Function appendRecord
+ * Desc     write a record at the end of the log and update the index
+ * Input    key    : key of the record
+ *          value  : value of the record
+ *          length : length of the value, 0 to remove the key
+ * Output   KV_OK, KV_FULL if there is no free segment, or KV_DEVICE_ERROR
+ */
+static tI2CKeyValueStatus appendRecord(uint8_t key, const uint8_t *value, uint8_t length) {
+	uint16_t size = length + RECORD_OVERHEAD;
+	tI2CKeyValueStatus status;
+	uint16_t address;
+	uint8_t buffer[2];
+
+	if (tailOffset + size > I2C_KV_SEGMENT_SIZE) {
+		status = openSegment();
+		if (status != KV_OK) {
+			return status;
+		}
+	}
+
+	address = segmentAddress(currentSegment) + tailOffset;
+
+	// A record not entirely written is overwritten by the next one
+	buffer[0] = key;
+	buffer[1] = length;
+	status = storeWrite(address, buffer, 2);
+	if (status == KV_OK && length != 0) {
+		status = storeWrite(address + 2, value, length);
+	}
+	if (status == KV_OK) {
+		buffer[0] = recordCheck(key, value, length);
+		buffer[1] = END_OF_SEGMENT;
+		status = storeWrite(address + 2 + length, buffer,
+				tailOffset + size < I2C_KV_SEGMENT_SIZE ? 2 : 1);
+	}
+	if (status != KV_OK) {
+		return status;
+	}
+
+	tailOffset += size;
+	keyIndex[key].address = length != 0 ? address : NO_RECORD;
+	keyIndex[key].length = length;
+
+	return KV_OK;
+}
+
+/*
+ * Function readRecord
+ * Desc     read and check the record at an address
+ * Input    address : address of the record
+ *          limit   : end of the segment
+ *          key     : key of the record
+ *          value   : value of the record, I2C_KV_MAX_VALUE_SIZE bytes
+ *          length  : length of the value
+ * Output   size of the record, 0 at the end of the segment or for a torn record
+ */
+static uint16_t readRecord(uint16_t address, uint16_t limit, uint8_t *key, uint8_t *value, uint8_t *length) {
+	uint8_t header[2];
+	uint8_t check;
+
+	if (address + RECORD_OVERHEAD > limit
+			|| i2cEepromCache.read(address, header, 2) != I2C_OK) {
+		return 0;
+	}
+	if (header[0] == END_OF_SEGMENT || header[0] >= I2C_KV_NB_KEYS
+			|| header[1] > I2C_KV_MAX_VALUE_SIZE
+			|| address + header[1] + RECORD_OVERHEAD > limit) {
+		return 0;
+	}
+	if (i2cEepromCache.read(address + 2, value, header[1]) != I2C_OK
+			|| i2cEepromCache.read(address + 2 + header[1], &check, 1) != I2C_OK
+			|| check != recordCheck(header[0], value, header[1])) {
+		return 0;
+	}
+
+	*key = header[0];
+	*length = header[1];
+	return header[1] + RECORD_OVERHEAD;
+}
+
+/*
+ * Function oldestSegment
+ * Desc     find the oldest used segment after a sequence
+ * Input    after    : sequence, only the newer segments are searched
+ *          anyAfter : 0 to search all the used segments
+ * Output   index of the segment, NO_SEGMENT if none
+ */
+static uint8_t oldestSegment(uint16_t after, uint8_t anyAfter) {
+	uint8_t oldest = NO_SEGMENT;
+	uint8_t segment;
+
+	for (segment = 0; segment < I2C_KV_NB_SEGMENTS; segment++) {
+		uint16_t sequence = segmentSequence[segment];
+
+		if (sequence == FREE_SEGMENT || (anyAfter && !isOlder(after, sequence))) {
+			continue;
+		}
+		if (oldest == NO_SEGMENT || isOlder(sequence, segmentSequence[oldest])) {
+			oldest = segment;
+		}
+	}
+	return oldest;
+}
+
+/*
+ * Function reclaimStep
+ * Desc     copy the live records of the oldest segment at the end of the log,
+ *          free the segment after its last record
+ * Input    maxRecords : maximum number of records read by the step
+ * Output   KV_OK, KV_FULL if no segment can be reclaimed, or KV_DEVICE_ERROR
+ */
+static tI2CKeyValueStatus reclaimStep(uint8_t maxRecords) {
+	uint8_t value[I2C_KV_MAX_VALUE_SIZE];
+	tI2CKeyValueStatus status;
+	uint16_t limit;
+	uint16_t size;
+	uint8_t key;
+	uint8_t length;
+
+	if (reclaimSegment == NO_SEGMENT) {
+		reclaimSegment = oldestSegment(0, 0);
+		if (reclaimSegment == NO_SEGMENT || reclaimSegment == currentSegment) {
+			reclaimSegment = NO_SEGMENT;
+			return KV_FULL;
+		}
+		reclaimAddress = segmentAddress(reclaimSegment) + SEGMENT_HEADER_SIZE;
+	}
+
+	limit = segmentAddress(reclaimSegment) + I2C_KV_SEGMENT_SIZE;
+	for (; maxRecords > 0; maxRecords--) {
+		size = readRecord(reclaimAddress, limit, &key, value, &length);
+		if (size == 0) {
+			// The copies are in the EEPROM before the segment is freed
+			if (i2cEepromCache.sync() != I2C_OK) {
+				return KV_DEVICE_ERROR;
+			}
+			status = writeSequence(reclaimSegment, FREE_SEGMENT);
+			if (status == KV_OK) {
+				reclaimSegment = NO_SEGMENT;
+			}
+			return status;
+		}
+
+		// Removed keys and overwritten values are dropped
+		if (length != 0 && keyIndex[key].address == reclaimAddress) {
+			status = appendRecord(key, value, length);
+			if (status != KV_OK) {
+				return status;
+			}
+		}
+		reclaimAddress += size;
+	}
+
+	return KV_OK;
+}
+
+/*
+ * Function reclaimOldestSegment
+ * Desc     end the reclaim of the oldest segment
+ * Input    none
+ * Output   KV_OK, KV_FULL if no segment can be reclaimed, or KV_DEVICE_ERROR
+ */
+static tI2CKeyValueStatus reclaimOldestSegment(void) {
+	tI2CKeyValueStatus status;
+
+	do {
+		status = reclaimStep(0xFF);
+	} while (status == KV_OK && reclaimSegment != NO_SEGMENT);
+
+	return status;
+}
+
+/**
+ * Rebuild the index by reading the segments from the oldest to the newest.
+ * An empty store is formatted. The EEPROM cache must be initialized.
+ */
+tI2CKeyValueStatus I2CKeyValueStore::mount(void) {
+	uint8_t value[I2C_KV_MAX_VALUE_SIZE];
+	uint8_t segment;
+	uint8_t key;
+
+	for (key = 0; key < I2C_KV_NB_KEYS; key++) {
+		keyIndex[key].address = NO_RECORD;
+	}
+	reclaimSegment = NO_SEGMENT;
+
+	for (segment = 0; segment < I2C_KV_NB_SEGMENTS; segment++) {
+		uint8_t header[SEGMENT_HEADER_SIZE];
+
+		if (i2cEepromCache.read(segmentAddress(segment), header, SEGMENT_HEADER_SIZE) != I2C_OK) {
+			return KV_DEVICE_ERROR;
+		}
+		segmentSequence[segment] = (header[0] << 8) | header[1];
+	}
+
+	segment = oldestSegment(0, 0);
+	if (segment == NO_SEGMENT) {
+		return format();
+	}
+
+	while (segment != NO_SEGMENT) {
+		uint16_t address = segmentAddress(segment) + SEGMENT_HEADER_SIZE;
+		uint16_t limit = segmentAddress(segment) + I2C_KV_SEGMENT_SIZE;
+		uint16_t size;
+		uint8_t length;
+
+		while ((size = readRecord(address, limit, &key, value, &length)) != 0) {
+			keyIndex[key].address = length != 0 ? address : NO_RECORD;
+			keyIndex[key].length = length;
+			address += size;
+		}
+
+		// The records are appended after the last record of the newest segment
+		currentSegment = segment;
+		tailOffset = address - segmentAddress(segment);
+		nextSequence = segmentSequence[segment] + 1;
+		if (nextSequence == FREE_SEGMENT) {
+			nextSequence = 0;
+		}
+
+		segment = oldestSegment(segmentSequence[segment], 1);
+	}
+
+	return KV_OK;
+}
+
+/**
+ * Erase the store, all the keys are removed.
+ */
+tI2CKeyValueStatus I2CKeyValueStore::format(void) {
+	uint8_t segment;
+	uint8_t key;
+
+	for (key = 0; key < I2C_KV_NB_KEYS; key++) {
+		keyIndex[key].address = NO_RECORD;
+	}
+	reclaimSegment = NO_SEGMENT;
+	for (segment = 0; segment < I2C_KV_NB_SEGMENTS; segment++) {
+		tI2CKeyValueStatus status = writeSequence(segment, FREE_SEGMENT);
+		if (status != KV_OK) {
+			return status;
+		}
+	}
+
+	currentSegment = I2C_KV_NB_SEGMENTS - 1;
+	nextSequence = 0;
+	return openSegment();
+}
+
+/**
+ * Write the value of a key.
+ * The record is appended to the log, a segment is reclaimed first when the
+ * log needs a new segment and only the reserved free segment is left.
+ *
+ * key      : key, lower than I2C_KV_NB_KEYS
+ * value    : value to write
+ * length   : length of the value, 1 to I2C_KV_MAX_VALUE_SIZE
+ */
+tI2CKeyValueStatus I2CKeyValueStore::put(uint8_t key, const uint8_t *value, uint8_t length) {
+	if (key >= I2C_KV_NB_KEYS) {
+		return KV_INVALID_KEY;
+	}
+	if (length == 0 || length > I2C_KV_MAX_VALUE_SIZE) {
+		return KV_INVALID_SIZE;
+	}
+
+	if (tailOffset + length + RECORD_OVERHEAD > I2C_KV_SEGMENT_SIZE
+			&& freeSegments() <= RESERVED_FREE_SEGMENTS) {
+		tI2CKeyValueStatus status = reclaimOldestSegment();
+		if (status == KV_DEVICE_ERROR) {
+			return status;
+		}
+
+		// Reclaiming may have opened a new segment
+		if (tailOffset + length + RECORD_OVERHEAD > I2C_KV_SEGMENT_SIZE
+				&& freeSegments() <= RESERVED_FREE_SEGMENTS) {
+			return KV_FULL;
+		}
+	}
+
+	return appendRecord(key, value, length);
+}
+
+/**
+ * Read the value of a key with one read of the EEPROM.
+ *
+ * key       : key
+ * value     : read value
+ * maxLength : size of the value buffer
+ * length    : length of the value
+ */
+tI2CKeyValueStatus I2CKeyValueStore::get(uint8_t key, uint8_t *value, uint8_t maxLength, uint8_t *length) {
+	if (key >= I2C_KV_NB_KEYS) {
+		return KV_INVALID_KEY;
+	}
+	if (keyIndex[key].address == NO_RECORD) {
+		return KV_NOT_FOUND;
+	}
+	if (keyIndex[key].length > maxLength) {
+		return KV_INVALID_SIZE;
+	}
+
+	if (i2cEepromCache.read(keyIndex[key].address + 2, value, keyIndex[key].length) != I2C_OK) {
+		return KV_DEVICE_ERROR;
+	}
+	*length = keyIndex[key].length;
+
+	return KV_OK;
+}
+
+/**
+ * Remove a key, a record without value is appended to the log.
+ *
+ * key      : key
+ */
+tI2CKeyValueStatus I2CKeyValueStore::remove(uint8_t key) {
+	if (key >= I2C_KV_NB_KEYS) {
+		return KV_INVALID_KEY;
+	}
+	if (keyIndex[key].address == NO_RECORD) {
+		return KV_NOT_FOUND;
+	}
+
+	if (tailOffset + RECORD_OVERHEAD > I2C_KV_SEGMENT_SIZE
+			&& freeSegments() <= RESERVED_FREE_SEGMENTS) {
+		tI2CKeyValueStatus status = reclaimOldestSegment();
+		if (status == KV_DEVICE_ERROR) {
+			return status;
+		}
+	}
+
+	return appendRecord(key, 0, 0);
+}
+
+/**
+ * Reclaim the oldest segment when the number of free segments is low.
+ * Each call reads at most COMPACTION_RECORDS_PER_STEP records of the segment
+ * and copies the live ones. The call after its last record waits the end of
+ * the write of the copies (sync of the EEPROM cache), then frees the segment.
+ * Must be called periodically, for example from loop().
+ */
+tI2CKeyValueStatus I2CKeyValueStore::compactStep(void) {
+	if (reclaimSegment == NO_SEGMENT && freeSegments() > COMPACTION_FREE_SEGMENTS) {
+		return KV_OK;
+	}
+
+	return reclaimStep(COMPACTION_RECORDS_PER_STEP);
+}
+
+#endif
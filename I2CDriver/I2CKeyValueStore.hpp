@@ -0,0 +1,103 @@
+/* ----------------------------------------------------------------------------
+  I2CKeyValueStore.hpp - Log-structured key-value store in an external EEPROM
+  -----------------------------------------------------------------------------
+  Supported processor: ATmega 328P
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CKEYVALUESTORE_HPP_
+#define I2CKEYVALUESTORE_HPP_
+
+#include "I2CEepromCache.hpp"
+
+/** Check key-value store usage */
+#ifndef KEY_VALUE_STORE_USAGE
+#error KEY_VALUE_STORE_USAGE must be defined
+#elif KEY_VALUE_STORE_USAGE != USE_KEY_VALUE_STORE && KEY_VALUE_STORE_USAGE != DONT_USE_KEY_VALUE_STORE
+#error KEY_VALUE_STORE_USAGE must be define with USE_KEY_VALUE_STORE or DONT_USE_KEY_VALUE_STORE
+#endif
+
+#if KEY_VALUE_STORE_USAGE == USE_KEY_VALUE_STORE
+
+/** Check consistency of the key-value store configuration */
+#if EEPROM_CACHE_USAGE != USE_EEPROM_CACHE
+#error The key-value store needs the EEPROM cache
+#endif
+#if !defined(I2C_KV_START_ADDRESS) || !defined(I2C_KV_SEGMENT_SIZE) || !defined(I2C_KV_NB_SEGMENTS)
+#error I2C_KV_START_ADDRESS, I2C_KV_SEGMENT_SIZE and I2C_KV_NB_SEGMENTS must be defined
+#elif I2C_KV_SEGMENT_SIZE % I2C_EEPROM_PAGE_SIZE != 0
+#error I2C_KV_SEGMENT_SIZE must be a multiple of I2C_EEPROM_PAGE_SIZE
+#elif I2C_KV_NB_SEGMENTS < 3
+#error I2C_KV_NB_SEGMENTS must be at least 3
+#elif I2C_KV_START_ADDRESS + I2C_KV_SEGMENT_SIZE * I2C_KV_NB_SEGMENTS > 65536L
+#error The key-value store must end before the address 65536
+#endif
+#ifndef I2C_KV_NB_KEYS
+#error I2C_KV_NB_KEYS must be defined
+#elif I2C_KV_NB_KEYS < 1 || I2C_KV_NB_KEYS > 255
+#error I2C_KV_NB_KEYS must be defined with a value between 1 and 255
+#endif
+#ifndef I2C_KV_MAX_VALUE_SIZE
+#error I2C_KV_MAX_VALUE_SIZE must be defined
+#elif I2C_KV_MAX_VALUE_SIZE < 1 || I2C_KV_MAX_VALUE_SIZE > 255 || I2C_KV_MAX_VALUE_SIZE + 6 > I2C_KV_SEGMENT_SIZE
+#error I2C_KV_MAX_VALUE_SIZE is inconsistent with I2C_KV_SEGMENT_SIZE
+#endif
+
+/**
+ * Definition of the status of the key-value store
+ */
+typedef enum {
+	KV_OK, KV_INVALID_KEY, KV_INVALID_SIZE, KV_NOT_FOUND, KV_FULL, KV_DEVICE_ERROR
+} tI2CKeyValueStatus;
+
+/**
+ * Log-structured key-value store in an external EEPROM.
+ *
+ * The records are appended to a log made of segments, an index in RAM gives
+ * the last record of each key. The oldest segment is reclaimed by copying
+ * its live records at the end of the log.
+ */
+class I2CKeyValueStore {
+
+public:
+
+	/* Rebuild the index from the log, the EEPROM cache must be initialized */
+	tI2CKeyValueStatus mount(void);
+	/* Erase the store */
+	tI2CKeyValueStatus format(void);
+	/* Write the value of a key */
+	tI2CKeyValueStatus put(uint8_t key, const uint8_t* value, uint8_t length);
+	/* Read the value of a key */
+	tI2CKeyValueStatus get(uint8_t key, uint8_t* value, uint8_t maxLength, uint8_t* length);
+	/* Remove a key */
+	tI2CKeyValueStatus remove(uint8_t key);
+	/* Reclaim the oldest segment when the free space is low */
+	tI2CKeyValueStatus compactStep(void);
+};
+
+/** Instantiation of the key-value store */
+extern I2CKeyValueStore i2cKeyValueStore;
+
+#endif
+
+#endif /* I2CKEYVALUESTORE_HPP_ */
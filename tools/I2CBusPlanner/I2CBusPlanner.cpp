@@ -0,0 +1,405 @@
+/* ----------------------------------------------------------------------------
+  I2CBusPlanner.cpp - Offline capacity planner of an I2C bus driven by the
+                      I2C driver (host tool)
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+  -----------------------------------------------------------------------------
+
+  BUILD:
+  g++ -std=c++11 -O2 -o I2CBusPlanner I2CBusPlanner.cpp
+
+  USAGE:
+  I2CBusPlanner [options] schedule.txt
+      --speed <Hz>        I2C_SPEED of the master (default 100000)
+      --fcpu <Hz>         F_CPU of the master (default 16000000)
+      --isr-cycles <n>    CPU cycles between TWINT and the write of TWCR
+                          in the interruption (default 80)
+      --timeline <us>     print the timeline of the first <us> microseconds
+
+  SCHEDULE:
+  One transaction per line, the first line has the highest priority.
+  # name  address  direction  length  period_us  repeated_start  stretch_us
+  temp    0x48     R          2       10000      1               0
+
+  direction       W for a write, R for a read
+  length          1 to 255 bytes, as a request of the driver
+  repeated_start  1 if a register byte is written first and the transfer
+                  follows after a repeated start (as gatherFrom does)
+  stretch_us      clock stretching of the slave during the transaction
+
+---------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+/** Time unit of the planner */
+typedef long long tNanoSeconds;
+
+/**
+ * Definition of a periodic transaction of the schedule
+ */
+typedef struct {
+	std::string name;
+	unsigned address;
+	char direction;
+	unsigned length;
+	tNanoSeconds period;
+	bool repeatedStart;
+	tNanoSeconds stretch;
+
+	/* Duration of the transaction on the bus */
+	tNanoSeconds duration;
+	/* Worst case response time, from the release to the stop condition */
+	tNanoSeconds responseTime;
+	/* Longest response time seen in the timeline */
+	tNanoSeconds simulatedResponseTime;
+} tPlannedTransaction;
+
+/**
+ * Definition of the timing of the master
+ */
+typedef struct {
+	long speed;
+	long cpuFrequency;
+	long isrCycles;
+	/* Duration of one SCL period with the TWBR really used */
+	tNanoSeconds bitTime;
+	/* Reaction time of the interruption */
+	tNanoSeconds isrTime;
+} tBusTiming;
+
+/*
+ * Function computeTiming
+ * Desc     compute the bit time with the rounding of TWBR done by the driver
+ * Input    timing : speed, CPU frequency and interruption cycles
+ * Output   none
+ */
+static void computeTiming(tBusTiming *timing) {
+	// Same computation as FREQUENCY_REGISTER_VALUE() with a prescaler of 1
+	long twbr = ((timing->cpuFrequency / timing->speed) - 16) / 2;
+
+	if (twbr < 0) {
+		twbr = 0;
+	}
+	timing->bitTime = (tNanoSeconds) (16 + 2 * twbr) * 1000000000LL / timing->cpuFrequency;
+	timing->isrTime = (tNanoSeconds) timing->isrCycles * 1000000000LL / timing->cpuFrequency;
+}
+
+/*
+ * Function transactionDuration
+ * Desc     duration of a transaction done by the driver, the bus is held by
+ *          the TWI (TWINT set) until the interruption writes TWCR
+ * Input    timing      : timing of the master
+ *          transaction : transaction
+ * Output   duration from the start condition to the bus free time after the stop
+ */
+static tNanoSeconds transactionDuration(const tBusTiming *timing, const tPlannedTransaction *transaction) {
+	// Start, address and data bytes (8 bits and the acknowledge), stop, bus free time
+	long bits = 1 + 9 + 9 * transaction->length + 1 + 1;
+	// One interruption after the start, the address and each byte
+	long interrupts = 2 + transaction->length;
+
+	if (transaction->repeatedStart) {
+		// Register byte, repeated start and second address
+		bits += 9 + 1 + 9;
+		interrupts += 3;
+	}
+
+	return bits * timing->bitTime + interrupts * timing->isrTime + transaction->stretch;
+}
+
+/*
+ * Function ceilDiv
+ * Desc     integer division rounded up
+ */
+static tNanoSeconds ceilDiv(tNanoSeconds a, tNanoSeconds b) {
+	return (a + b - 1) / b;
+}
+
+/*
+ * Function responseTime
+ * Desc     worst case response time of a transaction with a non preemptive
+ *          fixed priority dispatch: a transaction started on the bus is
+ *          never interrupted, the highest pending transaction starts next
+ * Input    transactions : schedule, ordered by priority
+ *          index        : transaction to analyse
+ * Output   worst case response time, -1 if the bus is overloaded
+ */
+static tNanoSeconds responseTime(const std::vector<tPlannedTransaction> &transactions, size_t index) {
+	const tPlannedTransaction &analysed = transactions[index];
+	tNanoSeconds blocking = 0;
+	tNanoSeconds busyPeriod;
+	tNanoSeconds worst = 0;
+	tNanoSeconds instances;
+	tNanoSeconds q;
+	size_t j;
+
+	// Blocking by a lower priority transaction already on the bus
+	for (j = index + 1; j < transactions.size(); j++) {
+		if (transactions[j].duration > blocking) {
+			blocking = transactions[j].duration;
+		}
+	}
+
+	// Length of the level-i busy period
+	busyPeriod = blocking + analysed.duration;
+	for (;;) {
+		tNanoSeconds next = blocking;
+
+		for (j = 0; j <= index; j++) {
+			next += ceilDiv(busyPeriod, transactions[j].period) * transactions[j].duration;
+		}
+		if (next == busyPeriod) {
+			break;
+		}
+		if (next > 1000 * analysed.period) {
+			return -1;
+		}
+		busyPeriod = next;
+	}
+
+	// Each instance of the busy period
+	instances = ceilDiv(busyPeriod, analysed.period);
+	for (q = 0; q < instances; q++) {
+		tNanoSeconds start = blocking + q * analysed.duration;
+
+		for (;;) {
+			tNanoSeconds next = blocking + q * analysed.duration;
+
+			for (j = 0; j < index; j++) {
+				next += (start / transactions[j].period + 1) * transactions[j].duration;
+			}
+			if (next == start) {
+				break;
+			}
+			if (next > 1000 * analysed.period) {
+				return -1;
+			}
+			start = next;
+		}
+
+		if (start - q * analysed.period + analysed.duration > worst) {
+			worst = start - q * analysed.period + analysed.duration;
+		}
+	}
+
+	return worst;
+}
+
+/*
+ * Function simulate
+ * Desc     build the timeline of the schedule, all transactions released at 0
+ * Input    transactions : schedule, ordered by priority
+ *          horizon      : end of the simulation
+ *          printed      : end of the printed timeline, 0 for no print
+ * Output   none, the simulated response times are updated
+ */
+static void simulate(std::vector<tPlannedTransaction> &transactions, tNanoSeconds horizon, tNanoSeconds printed) {
+	std::vector<tNanoSeconds> nextRelease(transactions.size(), 0);
+	std::vector<std::vector<tNanoSeconds> > pending(transactions.size());
+	tNanoSeconds now = 0;
+	size_t i;
+
+	while (now < horizon) {
+		size_t selected = transactions.size();
+		tNanoSeconds release;
+
+		for (i = 0; i < transactions.size(); i++) {
+			while (nextRelease[i] <= now) {
+				pending[i].push_back(nextRelease[i]);
+				nextRelease[i] += transactions[i].period;
+			}
+			if (selected == transactions.size() && !pending[i].empty()) {
+				selected = i;
+			}
+		}
+
+		if (selected == transactions.size()) {
+			// Bus idle until the next release
+			now = nextRelease[0];
+			for (i = 1; i < transactions.size(); i++) {
+				if (nextRelease[i] < now) {
+					now = nextRelease[i];
+				}
+			}
+			continue;
+		}
+
+		release = pending[selected].front();
+		pending[selected].erase(pending[selected].begin());
+		if (now < printed) {
+			printf("%12.1f us  %-16s start (released at %.1f us)\n", now / 1000.0,
+					transactions[selected].name.c_str(), release / 1000.0);
+		}
+		now += transactions[selected].duration;
+		if (now - release > transactions[selected].simulatedResponseTime) {
+			transactions[selected].simulatedResponseTime = now - release;
+		}
+		if (now < printed) {
+			printf("%12.1f us  %-16s stop  (latency %.1f us)\n", now / 1000.0,
+					transactions[selected].name.c_str(), (now - release) / 1000.0);
+		}
+	}
+}
+
+/*
+ * Function readSchedule
+ * Desc     read the schedule file
+ * Input    fileName     : name of the file
+ *          transactions : read transactions
+ * Output   true if the file is valid
+ */
+static bool readSchedule(const char *fileName, std::vector<tPlannedTransaction> &transactions) {
+	std::ifstream file(fileName);
+	std::string line;
+	int lineNumber = 0;
+
+	if (!file) {
+		fprintf(stderr, "Cannot open %s\n", fileName);
+		return false;
+	}
+
+	while (std::getline(file, line)) {
+		tPlannedTransaction transaction;
+		std::istringstream fields(line);
+		std::string address;
+		std::string direction;
+		double period;
+		double stretch;
+		int repeatedStart;
+
+		lineNumber++;
+		if (line.find_first_not_of(" \t\r") == std::string::npos || line[line.find_first_not_of(" \t")] == '#') {
+			continue;
+		}
+
+		// The driver transfers 1 to 255 bytes per request
+		if (!(fields >> transaction.name >> address >> direction >> transaction.length >> period
+				>> repeatedStart >> stretch) || (direction != "R" && direction != "W") || period <= 0
+				|| transaction.length == 0 || transaction.length > 255) {
+			fprintf(stderr, "%s:%d: invalid transaction\n", fileName, lineNumber);
+			return false;
+		}
+
+		transaction.address = strtoul(address.c_str(), 0, 0);
+		transaction.direction = direction[0];
+		transaction.period = (tNanoSeconds) (period * 1000);
+		transaction.repeatedStart = repeatedStart != 0;
+		transaction.stretch = (tNanoSeconds) (stretch * 1000);
+		transaction.responseTime = 0;
+		transaction.simulatedResponseTime = 0;
+		transactions.push_back(transaction);
+	}
+
+	if (transactions.empty()) {
+		fprintf(stderr, "%s: no transaction\n", fileName);
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char **argv) {
+	std::vector<tPlannedTransaction> transactions;
+	tBusTiming timing = { 100000L, 16000000L, 80, 0, 0 };
+	tNanoSeconds printed = 0;
+	tNanoSeconds horizon = 0;
+	const char *fileName = 0;
+	double utilisation = 0;
+	bool fits = true;
+	size_t i;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if (!strcmp(argv[arg], "--speed") && arg + 1 < argc) {
+			timing.speed = atol(argv[++arg]);
+		} else if (!strcmp(argv[arg], "--fcpu") && arg + 1 < argc) {
+			timing.cpuFrequency = atol(argv[++arg]);
+		} else if (!strcmp(argv[arg], "--isr-cycles") && arg + 1 < argc) {
+			timing.isrCycles = atol(argv[++arg]);
+		} else if (!strcmp(argv[arg], "--timeline") && arg + 1 < argc) {
+			printed = (tNanoSeconds) (atof(argv[++arg]) * 1000);
+		} else if (argv[arg][0] != '-' && fileName == 0) {
+			fileName = argv[arg];
+		} else {
+			fileName = 0;
+			break;
+		}
+	}
+
+	if (fileName == 0 || timing.speed <= 0 || timing.cpuFrequency <= 0) {
+		fprintf(stderr, "usage: %s [--speed Hz] [--fcpu Hz] [--isr-cycles n] [--timeline us] schedule.txt\n", argv[0]);
+		return 2;
+	}
+	if (!readSchedule(fileName, transactions)) {
+		return 2;
+	}
+
+	computeTiming(&timing);
+	for (i = 0; i < transactions.size(); i++) {
+		transactions[i].duration = transactionDuration(&timing, &transactions[i]);
+		utilisation += (double) transactions[i].duration / transactions[i].period;
+		if (transactions[i].period > horizon) {
+			horizon = transactions[i].period;
+		}
+	}
+	// A fully loaded bus has no idle time to absorb the blocking
+	for (i = 0; i < transactions.size(); i++) {
+		transactions[i].responseTime = utilisation < 1.0 ? responseTime(transactions, i) : -1;
+	}
+
+	// The timeline covers the synchronous release of all transactions
+	if (printed > 0) {
+		printf("Timeline:\n");
+	}
+	simulate(transactions, 10 * horizon > printed ? 10 * horizon : printed, printed);
+
+	printf("SCL %.0f Hz (TWBR rounding), interruption %.2f us, bit %.2f us\n",
+			1e9 / timing.bitTime, timing.isrTime / 1000.0, timing.bitTime / 1000.0);
+	printf("%-16s %6s %4s %6s %12s %12s %8s %14s %14s %s\n", "name", "addr", "dir", "length",
+			"duration_us", "period_us", "load_%", "worst_resp_us", "simulated_us", "fits");
+	for (i = 0; i < transactions.size(); i++) {
+		const tPlannedTransaction &t = transactions[i];
+		bool transactionFits = t.responseTime >= 0 && t.responseTime <= t.period;
+		char worst[16];
+
+		fits = fits && transactionFits;
+		if (t.responseTime >= 0) {
+			snprintf(worst, sizeof(worst), "%.1f", t.responseTime / 1000.0);
+		} else {
+			snprintf(worst, sizeof(worst), "unbounded");
+		}
+		printf("%-16s 0x%02X %4c %6u %12.1f %12.1f %8.2f %14s %14.1f %s\n", t.name.c_str(), t.address,
+				t.direction, t.length, t.duration / 1000.0, t.period / 1000.0,
+				100.0 * t.duration / t.period, worst,
+				t.simulatedResponseTime / 1000.0, transactionFits ? "yes" : "NO");
+	}
+	printf("Bus utilisation %.2f %%, schedule %s\n", 100.0 * utilisation, fits ? "fits" : "DOES NOT FIT");
+
+	return fits ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+/* ----------------------------------------------------------------------------
+  Arduino.h - Time functions of the Arduino core on the simulated time
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CSIMULATION_ARDUINO_H_
+#define I2CSIMULATION_ARDUINO_H_
+
+#include <stdint.h>
+#include <avr/io.h>
+
+/* Simulated time since the start */
+unsigned long micros(void);
+unsigned long millis(void);
+
+/* Advance the simulated time */
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#endif /* I2CSIMULATION_ARDUINO_H_ */
@@ -0,0 +1,634 @@
+/* ----------------------------------------------------------------------------
+  I2CBenchmark.cpp - Benchmark of the master driver on the simulated devices
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include "Arduino.h"
+#include "I2CDriver.hpp"
+#include "I2CEepromCache.hpp"
+#include "I2CSimulatedDevices.hpp"
+
+#if I2C_MODE != MODE_MASTER
+#error The benchmark needs the driver configured in master mode
+#endif
+
+/* Addresses of the simulated devices */
+#define EEPROM_ADDRESS			0x50
+#define SENSOR_ADDRESS			0x40
+#define IMU_ADDRESS				0x68
+#define MUX_ADDRESS				0x70
+#define GAUGE_ADDRESS			0x0B
+#define DAC_ADDRESS				0x60
+#define ADC_ADDRESS				0x4D
+#define URGENT_ADDRESS			0x30
+
+/* Number of samples of a stream */
+#define STREAM_LENGTH			1000
+
+/* Devices of the benchmark */
+static I2CSimulatedEeprom eeprom(EEPROM_ADDRESS, 32768, 64, 2);
+static I2CSimulatedImu imu(IMU_ADDRESS);
+static I2CSimulatedMultiplexer mux(MUX_ADDRESS);
+static I2CSimulatedTemperatureSensor sensor0(SENSOR_ADDRESS);
+static I2CSimulatedTemperatureSensor sensor1(SENSOR_ADDRESS);
+static I2CSimulatedBatteryGauge gauge(GAUGE_ADDRESS);
+static I2CSimulatedDac dac(DAC_ADDRESS);
+static I2CSimulatedAdc adc(ADC_ADDRESS);
+
+/* Start of the current measure */
+static tSimulatedTime measureStart;
+
+/*
+ * Function beginMeasure
+ * Desc     start the measure of a scenario
+ */
+static void beginMeasure(void) {
+	i2cSimulatedBus.clearStatistics();
+	measureStart = i2cSimulatedBus.now();
+}
+
+/*
+ * Function endMeasure
+ * Desc     print the measure of a scenario
+ */
+static void endMeasure(const char *scenario) {
+	const tI2CSimulatedStatistics& statistics = i2cSimulatedBus.getStatistics();
+
+	printf("%-32s %10.1f us %5lu starts %6lu bytes %4lu nacks %10.1f us stretched\n", scenario,
+			(i2cSimulatedBus.now() - measureStart) / 1000.0, statistics.starts, statistics.bytes,
+			statistics.nacks, statistics.stretching / 1000.0);
+}
+
+/*
+ * Function send
+ * Desc     write to a slave and wait the end of the transfer
+ */
+static tI2CDriverError send(uint8_t address, uint8_t *data, uint8_t length) {
+	i2cDriver.sendTo(address, data, length);
+	while (!i2cDriver.isReady())
+		;
+	return i2cDriver.getLastStatus();
+}
+
+/*
+ * Function receive
+ * Desc     read from a slave and wait the end of the transfer
+ */
+static tI2CDriverError receive(uint8_t address, uint8_t *data, uint8_t length) {
+	i2cDriver.readFrom(address, data, length);
+	while (!i2cDriver.isReady())
+		;
+	return i2cDriver.getLastStatus();
+}
+
+/*
+ * Function benchmarkEeprom
+ * Desc     page write with ACK polling, then read back
+ */
+static void benchmarkEeprom(void) {
+	uint8_t frame[2 + 64];
+	uint8_t data[64];
+	unsigned polls = 0;
+	uint8_t i;
+
+	frame[0] = 0x01;
+	frame[1] = 0x00;
+	for (i = 0; i < 64; i++) {
+		frame[2 + i] = i;
+	}
+
+	beginMeasure();
+	send(EEPROM_ADDRESS, frame, sizeof(frame));
+	endMeasure("EEPROM page write (64 bytes)");
+
+	beginMeasure();
+	while (!i2cDriver.probe(EEPROM_ADDRESS)) {
+		polls++;
+	}
+	endMeasure("EEPROM write cycle, ACK polling");
+
+	beginMeasure();
+	send(EEPROM_ADDRESS, frame, 2);
+	receive(EEPROM_ADDRESS, data, sizeof(data));
+	endMeasure("EEPROM random read (64 bytes)");
+
+	for (i = 0; i < 64 && data[i] == i; i++)
+		;
+	printf("    %u polls, data %s\n", polls, i == 64 ? "ok" : "CORRUPTED");
+}
+
+/*
+ * Function benchmarkSensor
+ * Desc     conversion with hold master, then without hold master
+ */
+static void benchmarkSensor(void) {
+	uint8_t channel;
+	uint8_t command = 0xE3;
+	uint8_t result[3];
+	unsigned polls = 0;
+
+	sensor0.setTemperature(21.5);
+	channel = 0x01;
+	send(MUX_ADDRESS, &channel, 1);
+
+	beginMeasure();
+	send(SENSOR_ADDRESS, &command, 1);
+	receive(SENSOR_ADDRESS, result, sizeof(result));
+	endMeasure("Sensor hold master");
+
+	command = 0xF3;
+	beginMeasure();
+	send(SENSOR_ADDRESS, &command, 1);
+	while (receive(SENSOR_ADDRESS, result, sizeof(result)) != I2C_OK) {
+		polls++;
+		delay(1);
+	}
+	endMeasure("Sensor no hold, 1 ms polling");
+	printf("    %u polls, %.2f C\n", polls, -46.85 + 175.72 * ((result[0] << 8) | (result[1] & 0xFC)) / 65536.0);
+
+	channel = 0x00;
+	send(MUX_ADDRESS, &channel, 1);
+}
+
+/*
+ * Function benchmarkImu
+ * Desc     read of the FIFO count and of the FIFO content
+ */
+static void benchmarkImu(void) {
+	uint8_t frame[2] = { 0x6A, 0x44 };
+	uint8_t count[2];
+	uint8_t data[240];
+	uint8_t reg;
+	unsigned i;
+	unsigned ok = 1;
+
+	send(IMU_ADDRESS, frame, sizeof(frame));
+	delay(25);
+
+	beginMeasure();
+	reg = 0x72;
+	send(IMU_ADDRESS, &reg, 1);
+	receive(IMU_ADDRESS, count, sizeof(count));
+	reg = 0x74;
+	send(IMU_ADDRESS, &reg, 1);
+	receive(IMU_ADDRESS, data, sizeof(data));
+	endMeasure("IMU FIFO count and 20 samples");
+
+	for (i = 2; i < sizeof(data); i += 2) {
+		uint16_t previous = (data[i - 2] << 8) | data[i - 1];
+
+		ok = ok && (uint16_t) ((data[i] << 8) | data[i + 1]) == (uint16_t) (previous + 1);
+	}
+	printf("    FIFO count %u bytes, samples %s\n", (count[0] << 8) | count[1], ok ? "continuous" : "NOT CONTINUOUS");
+}
+
+/*
+ * Function benchmarkMultiplexer
+ * Desc     two sensors with the same address behind the multiplexer
+ */
+static void benchmarkMultiplexer(void) {
+	uint8_t channel;
+	uint8_t command = 0xE3;
+	uint8_t result[3];
+
+	sensor0.setConversionTime(SIMULATED_MS(11));
+	sensor1.setConversionTime(SIMULATED_MS(11));
+	sensor1.setTemperature(30.0);
+
+	beginMeasure();
+	channel = 0x01;
+	send(MUX_ADDRESS, &channel, 1);
+	send(SENSOR_ADDRESS, &command, 1);
+	receive(SENSOR_ADDRESS, result, sizeof(result));
+	channel = 0x02;
+	send(MUX_ADDRESS, &channel, 1);
+	send(SENSOR_ADDRESS, &command, 1);
+	receive(SENSOR_ADDRESS, result, sizeof(result));
+	endMeasure("Mux, 2 sensors at 0x40");
+	printf("    channel 1: %.2f C\n", -46.85 + 175.72 * ((result[0] << 8) | (result[1] & 0xFC)) / 65536.0);
+
+	channel = 0x00;
+	send(MUX_ADDRESS, &channel, 1);
+}
+
+/*
+ * Function benchmarkGauge
+ * Desc     SMBus word and block reads with clock stretching
+ */
+static void benchmarkGauge(void) {
+	uint8_t command = 0x09;
+	uint8_t word[2];
+	uint8_t name[33];
+	uint8_t length;
+
+	beginMeasure();
+	send(GAUGE_ADDRESS, &command, 1);
+	receive(GAUGE_ADDRESS, word, sizeof(word));
+	endMeasure("Gauge voltage word");
+	printf("    %u mV\n", word[0] | (word[1] << 8));
+
+	command = 0x21;
+	beginMeasure();
+	send(GAUGE_ADDRESS, &command, 1);
+#if PREDICATE_READ_USAGE == USE_PREDICATE_READ
+	i2cDriver.readLengthPrefixed(GAUGE_ADDRESS, name, sizeof(name));
+	while (!i2cDriver.isReady())
+		;
+	length = i2cDriver.getReceivedLength();
+	endMeasure("Gauge device name, prefixed");
+#else
+	receive(GAUGE_ADDRESS, name, sizeof(name));
+	length = name[0] + 1;
+	endMeasure("Gauge device name, 33 bytes");
+#endif
+	printf("    %.*s\n", length - 1, (const char*) name + 1);
+}
+
+#if EEPROM_CACHE_USAGE == USE_EEPROM_CACHE
+/* Number of pages written through the cache */
+#define CACHE_BENCHMARK_PAGES	64
+/* Number and size of the records appended through the cache */
+#define CACHE_APPEND_RECORDS	400
+#define CACHE_APPEND_SIZE		8
+
+/*
+ * Function benchmarkEepromCache
+ * Desc     pages written through the cache, striped on the EEPROM
+ */
+static void benchmarkEepromCache(void) {
+	uint8_t page[I2C_EEPROM_PAGE_SIZE];
+	uint8_t check[I2C_EEPROM_PAGE_SIZE];
+	char scenario[40];
+	unsigned errors = 0;
+	unsigned p;
+	unsigned i;
+
+	// The EEPROM of the other scenarios is the first one
+	for (i = 0; i < I2C_EEPROM_NB_DEVICES; i++) {
+		if (I2C_EEPROM_DEVICE_ADDRESS + i != EEPROM_ADDRESS) {
+			i2cSimulatedBus.attach(new I2CSimulatedEeprom(I2C_EEPROM_DEVICE_ADDRESS + i, I2C_EEPROM_DEVICE_SIZE, I2C_EEPROM_PAGE_SIZE, 2));
+		}
+	}
+	i2cEepromCache.initialisation();
+	delay(10);
+
+	snprintf(scenario, sizeof(scenario), "Cache, %u pages on %u EEPROM", CACHE_BENCHMARK_PAGES, I2C_EEPROM_NB_DEVICES);
+	beginMeasure();
+	for (p = 0; p < CACHE_BENCHMARK_PAGES; p++) {
+		for (i = 0; i < I2C_EEPROM_PAGE_SIZE; i++) {
+			page[i] = p + i;
+		}
+		// All the pages are dirty and the EEPROM in their write cycle
+		while (i2cEepromCache.write(p * I2C_EEPROM_PAGE_SIZE, page, I2C_EEPROM_PAGE_SIZE) != I2C_OK)
+			;
+	}
+	i2cEepromCache.sync();
+	endMeasure(scenario);
+	printf("    %.0f bytes/s\n", CACHE_BENCHMARK_PAGES * I2C_EEPROM_PAGE_SIZE * 1000000000.0
+			/ (i2cSimulatedBus.now() - measureStart));
+
+	// Read back from the EEPROM, the cache keeps only the last pages
+	for (p = 0; p < CACHE_BENCHMARK_PAGES; p++) {
+		i2cEepromCache.read(p * I2C_EEPROM_PAGE_SIZE, check, I2C_EEPROM_PAGE_SIZE);
+		for (i = 0; i < I2C_EEPROM_PAGE_SIZE; i++) {
+			errors += check[i] != (uint8_t) (p + i);
+		}
+	}
+	printf("    data %s\n", errors == 0 ? "ok" : "CORRUPTED");
+}
+
+/*
+ * Function benchmarkEepromAppend
+ * Desc     records smaller than a page appended through the cache, process
+ *          is called after each record as in loop()
+ */
+static void benchmarkEepromAppend(void) {
+	const uint32_t start = CACHE_BENCHMARK_PAGES * I2C_EEPROM_PAGE_SIZE;
+	uint8_t record[CACHE_APPEND_SIZE];
+	tSimulatedTime longest = 0;
+	unsigned refused = 0;
+	unsigned errors = 0;
+	unsigned r;
+	unsigned i;
+
+	beginMeasure();
+	for (r = 0; r < CACHE_APPEND_RECORDS; r++) {
+		for (i = 0; i < CACHE_APPEND_SIZE; i++) {
+			record[i] = r + i;
+		}
+		for (;;) {
+			tSimulatedTime callStart = i2cSimulatedBus.now();
+			tI2CDriverError status = i2cEepromCache.write(start + r * CACHE_APPEND_SIZE, record, CACHE_APPEND_SIZE);
+
+			if (i2cSimulatedBus.now() - callStart > longest) {
+				longest = i2cSimulatedBus.now() - callStart;
+			}
+			i2cEepromCache.process();
+			if (status == I2C_OK) {
+				break;
+			}
+			refused++;
+		}
+	}
+	i2cEepromCache.sync();
+	endMeasure("Cache, appends of 8 bytes");
+	printf("    longest write %.1f us, %u writes refused\n", longest / 1000.0, refused);
+
+	for (r = 0; r < CACHE_APPEND_RECORDS; r++) {
+		i2cEepromCache.read(start + r * CACHE_APPEND_SIZE, record, CACHE_APPEND_SIZE);
+		for (i = 0; i < CACHE_APPEND_SIZE; i++) {
+			errors += record[i] != (uint8_t) (r + i);
+		}
+	}
+	printf("    data %s\n", errors == 0 ? "ok" : "CORRUPTED");
+}
+#endif
+
+#if STREAM_USAGE == USE_STREAM
+/*
+ * Function printStreamLoad
+ * Desc     print the CPU time spent in the interruptions of a stream
+ */
+static void printStreamLoad(void) {
+	const tI2CSimulatedStatistics& statistics = i2cSimulatedBus.getStatistics();
+	double interrupts = statistics.interrupts + statistics.timerInterrupts;
+
+	printf("    %.1f interruptions per sample, CPU load %.1f %% at %u cycles each\n",
+			interrupts / STREAM_LENGTH,
+			100.0 * interrupts * 80 * 1000000000.0 / F_CPU / (i2cSimulatedBus.now() - measureStart), 80);
+}
+
+/*
+ * Function benchmarkDacStream
+ * Desc     samples at 10 kHz to a DAC, framed then continuous
+ */
+static void benchmarkDacStream(tI2CStreamFraming framing, const char *scenario) {
+	tSimulatedTime shortest;
+	tSimulatedTime longest;
+	unsigned written = 0;
+	uint8_t sample[2];
+
+	dac.takeUpdateIntervals(&shortest, &longest);
+	beginMeasure();
+	i2cDriver.startStream(DAC_ADDRESS, STREAM_OUTPUT, framing, 2, 100);
+	while (written < STREAM_LENGTH) {
+		sample[0] = (written >> 8) & 0x0F;
+		sample[1] = written & 0xFF;
+		if (i2cDriver.writeStreamSample(sample)) {
+			written++;
+		} else {
+			// The application fills the buffer each millisecond
+			delay(1);
+		}
+	}
+	while (i2cDriver.getStreamCount() > 0) {
+		delayMicroseconds(100);
+	}
+	i2cDriver.stopStream();
+	endMeasure(scenario);
+
+	dac.takeUpdateIntervals(&shortest, &longest);
+	printf("    %u underruns, DAC period %.1f to %.1f us\n", i2cDriver.getStreamUnderruns(),
+			shortest / 1000.0, longest / 1000.0);
+	printStreamLoad();
+}
+
+/*
+ * Function benchmarkAdcStream
+ * Desc     samples at 10 kHz from an ADC, continuous frame
+ */
+static void benchmarkAdcStream(void) {
+	unsigned received = 0;
+	unsigned gaps = 0;
+	uint16_t previous = 0;
+	uint8_t sample[2];
+
+	beginMeasure();
+	i2cDriver.startStream(ADC_ADDRESS, STREAM_INPUT, STREAM_CONTINUOUS, 2, 100);
+	while (received < STREAM_LENGTH) {
+		while (received < STREAM_LENGTH && i2cDriver.readStreamSample(sample)) {
+			uint16_t value = (sample[0] << 8) | sample[1];
+
+			gaps += received > 0 && value != ((previous + 1) & 0x0FFF);
+			previous = value;
+			received++;
+		}
+		delay(1);
+	}
+	i2cDriver.stopStream();
+	endMeasure("ADC stream 10 kHz, continuous");
+	printf("    %u overruns, %u gaps\n", i2cDriver.getStreamOverruns(), gaps);
+	printStreamLoad();
+}
+#endif
+
+#if SLICING_USAGE == USE_SLICING
+/* Number of bytes of the long read */
+#define LONG_READ_LENGTH		255
+/* Time of the urgent request after the start of the long read */
+#define URGENT_DELAY_US			200
+
+/**
+ * Slave of the urgent request, keeps the time of the end of the request
+ */
+class I2CUrgentDevice: public I2CSimulatedDevice {
+public:
+	I2CUrgentDevice(uint8_t address) :
+			I2CSimulatedDevice(address), end(0) {
+	}
+
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now) {
+		return 1;
+	}
+
+	uint8_t write(uint8_t value, tSimulatedTime now) {
+		return 1;
+	}
+
+	uint8_t read(tSimulatedTime now) {
+		return 0;
+	}
+
+	void stop(tSimulatedTime now) {
+		end = now;
+	}
+
+	tSimulatedTime end;
+};
+
+static I2CUrgentDevice urgent(URGENT_ADDRESS);
+static uint8_t urgentData[2];
+static tSimulatedTime urgentTime;
+
+/*
+ * Function urgentRequest
+ * Desc     interruption of a pin, read of the urgent device
+ */
+static void urgentRequest(void) {
+	urgentTime = i2cSimulatedBus.now();
+	i2cDriver.readFrom(URGENT_ADDRESS, urgentData, sizeof(urgentData));
+}
+
+/*
+ * Function urgentMark
+ * Desc     interruption of a pin, the driver is busy until the end of the read
+ */
+static void urgentMark(void) {
+	urgentTime = i2cSimulatedBus.now();
+}
+
+/*
+ * Function benchmarkSlicing
+ * Desc     latency of an urgent request during a long read of the EEPROM,
+ *          in one request then in slices
+ */
+static void benchmarkSlicing(void) {
+	uint8_t address[2] = { 0x01, 0x00 };
+	uint8_t whole[LONG_READ_LENGTH];
+	uint8_t sliced[LONG_READ_LENGTH];
+	char scenario[40];
+
+	i2cSimulatedBus.attach(&urgent);
+
+	beginMeasure();
+	i2cSimulatedBus.setExternalInterrupt(measureStart + SIMULATED_US(URGENT_DELAY_US), urgentMark);
+	send(EEPROM_ADDRESS, address, sizeof(address));
+	receive(EEPROM_ADDRESS, whole, sizeof(whole));
+	receive(URGENT_ADDRESS, urgentData, sizeof(urgentData));
+	endMeasure("EEPROM read 255 bytes, one frame");
+	printf("    urgent request latency %.1f us\n", (urgent.end - urgentTime) / 1000.0);
+
+	snprintf(scenario, sizeof(scenario), "EEPROM read 255 bytes, slices of %u", I2C_SLICE_SIZE);
+	beginMeasure();
+	i2cSimulatedBus.setExternalInterrupt(measureStart + SIMULATED_US(URGENT_DELAY_US), urgentRequest);
+	i2cDriver.readMemory(EEPROM_ADDRESS, 0x0100, 2, sliced, sizeof(sliced));
+	while (!i2cDriver.isMemoryReadDone())
+		;
+	endMeasure(scenario);
+	printf("    urgent request latency %.1f us, data %s\n", (urgent.end - urgentTime) / 1000.0,
+			i2cDriver.getMemoryReadStatus() == I2C_OK && memcmp(whole, sliced, sizeof(whole)) == 0 ?
+					"ok" : "CORRUPTED");
+}
+#endif
+
+#if DUAL_MODE_USAGE == USE_DUAL_MODE
+/* Frame received by the client */
+static uint8_t clientFrame[I2C_BUFFER_SIZE];
+static uint8_t clientFrameLength;
+
+/* Data sent by the client */
+static uint8_t clientData[4] = { 0xA1, 0xA2, 0xA3, 0xA4 };
+
+/*
+ * Function clientReceive
+ * Desc     reception callback of the client
+ */
+static void clientReceive(uint8_t *buffer, uint8_t size) {
+	memcpy(clientFrame, buffer, size);
+	clientFrameLength = size;
+}
+
+/*
+ * Function clientTransmit
+ * Desc     transmission callback of the client
+ */
+static uint8_t* clientTransmit(void) {
+	return clientData;
+}
+
+/*
+ * Function benchmarkDualMode
+ * Desc     an external master writes to and reads from the client, between
+ *          the reads of the EEPROM by the host
+ */
+static void benchmarkDualMode(void) {
+	uint8_t command[4] = { 0x10, 0x20, 0x30, 0x40 };
+	uint8_t address[2] = { 0x01, 0x00 };
+	uint8_t answer[sizeof(clientData)];
+	uint8_t data[16];
+	int written;
+	int read;
+	uint8_t i;
+
+	i2cDriver.setSlaveReceivedCallback(clientReceive);
+	i2cDriver.setSlaveTransmitCallback(clientTransmit, sizeof(clientData));
+
+	beginMeasure();
+	written = i2cSimulatedBus.clientWrite(I2C_ADDRESS, command, sizeof(command));
+	send(EEPROM_ADDRESS, address, sizeof(address));
+	receive(EEPROM_ADDRESS, data, sizeof(data));
+	read = i2cSimulatedBus.clientRead(I2C_ADDRESS, answer, sizeof(answer));
+	endMeasure("Dual mode, host and client");
+
+	for (i = 0; i < sizeof(data) && data[i] == i; i++)
+		;
+	printf("    client received %d bytes %s, sent %d bytes %s, host data %s\n", written,
+			clientFrameLength == sizeof(command) && memcmp(clientFrame, command, sizeof(command)) == 0 ?
+					"ok" : "CORRUPTED",
+			read, memcmp(answer, clientData, sizeof(answer)) == 0 ? "ok" : "CORRUPTED",
+			i == sizeof(data) ? "ok" : "CORRUPTED");
+}
+#endif
+
+int main(void) {
+	i2cSimulatedBus.attach(&eeprom);
+	i2cSimulatedBus.attach(&imu);
+	i2cSimulatedBus.attach(&mux);
+	i2cSimulatedBus.attach(&gauge);
+	i2cSimulatedBus.attach(&dac);
+	i2cSimulatedBus.attach(&adc);
+	// Both sensors have the same address, they are reached through the mux
+	mux.attach(0, &sensor0);
+	mux.attach(1, &sensor1);
+
+	i2cDriver.initialisation();
+	printf("I2C_SPEED %ld Hz, F_CPU %ld Hz, %s\n", (long) I2C_SPEED, (long) F_CPU,
+			I2C_CONTROLLER == CONTROLLER_TWI ? "TWI" : "TWI0 in smart mode");
+
+	benchmarkEeprom();
+	benchmarkSensor();
+	benchmarkImu();
+	benchmarkMultiplexer();
+	benchmarkGauge();
+#if DUAL_MODE_USAGE == USE_DUAL_MODE
+	benchmarkDualMode();
+#endif
+#if EEPROM_CACHE_USAGE == USE_EEPROM_CACHE
+	benchmarkEepromCache();
+	benchmarkEepromAppend();
+#endif
+#if SLICING_USAGE == USE_SLICING
+	benchmarkSlicing();
+#endif
+#if STREAM_USAGE == USE_STREAM
+	benchmarkDacStream(STREAM_FRAMED, "DAC stream 10 kHz, framed");
+	benchmarkDacStream(STREAM_CONTINUOUS, "DAC stream 10 kHz, continuous");
+	benchmarkAdcStream();
+#endif
+
+	return 0;
+}
@@ -0,0 +1,222 @@
+/* ----------------------------------------------------------------------------
+  I2CReplay.cpp - Replay of a trace of the master on the simulated bus
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "Arduino.h"
+#include "I2CDriver.hpp"
+#include "I2CSimulation.hpp"
+
+#if I2C_MODE != MODE_MASTER
+#error The replay needs the driver configured in master mode
+#endif
+
+/* Size of a request in the trace file */
+#define TRACE_RECORD_SIZE		5
+
+/* Bit of the interval in milliseconds */
+#define INTERVAL_MS				0x8000
+
+/**
+ * Request read from the trace file
+ */
+typedef struct {
+	tSimulatedTime interval;
+	tSimulatedTime resolution;
+	uint8_t address;
+	uint8_t read;
+	uint8_t length;
+	uint8_t status;
+} tReplayRequest;
+
+/**
+ * Slave answering the requests of the trace.
+ * The address is not acknowledged when the request failed in the trace.
+ */
+class I2CReplayDevice: public I2CSimulatedDevice {
+public:
+	I2CReplayDevice(uint8_t address) :
+			I2CSimulatedDevice(address), refuse(0), counter(0) {
+	}
+
+	/* Set before each request with the status of the trace */
+	uint8_t refuse;
+
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now) {
+		return !refuse;
+	}
+
+	uint8_t write(uint8_t value, tSimulatedTime now) {
+		return 1;
+	}
+
+	uint8_t read(tSimulatedTime now) {
+		return counter++;
+	}
+
+private:
+	uint8_t counter;
+};
+
+/* One device per address of the trace */
+static I2CReplayDevice *devices[128];
+
+/*
+ * Function loadTrace
+ * Desc     read the requests of a trace file
+ */
+static uint8_t loadTrace(const char *fileName, std::vector<tReplayRequest>& requests) {
+	FILE *file = fopen(fileName, "rb");
+	uint8_t record[TRACE_RECORD_SIZE];
+
+	if (file == 0) {
+		return 0;
+	}
+
+	while (fread(record, 1, TRACE_RECORD_SIZE, file) == TRACE_RECORD_SIZE) {
+		tReplayRequest request;
+		uint16_t interval = record[0] | (record[1] << 8);
+
+		if (interval & INTERVAL_MS) {
+			request.interval = SIMULATED_MS(interval & ~INTERVAL_MS);
+			request.resolution = SIMULATED_MS(1);
+		} else {
+			request.interval = SIMULATED_US(interval);
+			request.resolution = SIMULATED_US(1);
+		}
+		request.address = record[2] >> 1;
+		request.read = record[2] & 0x01;
+		request.length = record[3];
+		request.status = record[4];
+		requests.push_back(request);
+	}
+
+	fclose(file);
+	return 1;
+}
+
+/*
+ * Function percentile
+ * Desc     value of a percentile of sorted durations, in us
+ */
+static double percentile(const std::vector<tSimulatedTime>& sorted, unsigned rank) {
+	return sorted[(sorted.size() - 1) * rank / 100] / 1000.0;
+}
+
+int main(int argc, char *argv[]) {
+	std::vector<tReplayRequest> requests;
+	std::vector<tSimulatedTime> latencies;
+	uint8_t data[255];
+	uint8_t recorded = 0;
+	const char *fileName = 0;
+	tSimulatedTime scheduled;
+	tSimulatedTime replayStart;
+	unsigned long bytes = 0;
+	unsigned late = 0;
+	unsigned mismatches = 0;
+	double total = 0;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--recorded") == 0) {
+			recorded = 1;
+		} else {
+			fileName = argv[i];
+		}
+	}
+	if (fileName == 0 || !loadTrace(fileName, requests)) {
+		fprintf(stderr, "usage: I2CReplay [--recorded] trace.bin\n");
+		return 2;
+	}
+	if (requests.empty()) {
+		fprintf(stderr, "%s: no request\n", fileName);
+		return 2;
+	}
+
+	for (const tReplayRequest& request : requests) {
+		if (devices[request.address] == 0) {
+			devices[request.address] = new I2CReplayDevice(request.address);
+			i2cSimulatedBus.attach(devices[request.address]);
+		}
+	}
+
+	i2cDriver.initialisation();
+	printf("I2C_SPEED %ld Hz, F_CPU %ld Hz, %s speed\n", (long) I2C_SPEED, (long) F_CPU,
+			recorded ? "recorded" : "full");
+
+	i2cSimulatedBus.clearStatistics();
+	replayStart = i2cSimulatedBus.now();
+	scheduled = replayStart;
+	for (const tReplayRequest& request : requests) {
+		// The interval of the first request is the time from the start of the master
+		if (recorded && &request != &requests[0]) {
+			scheduled += request.interval;
+			if (i2cSimulatedBus.now() < scheduled) {
+				i2cSimulatedBus.advance(scheduled - i2cSimulatedBus.now());
+			} else if (i2cSimulatedBus.now() > scheduled + request.resolution) {
+				// The bus was still busy at the time of the request in the trace
+				late++;
+			}
+		} else {
+			scheduled = i2cSimulatedBus.now();
+		}
+
+		devices[request.address]->refuse = request.status == I2C_MISSING_ACK;
+		if (request.read) {
+			i2cDriver.readFrom(request.address, data, request.length);
+		} else {
+			i2cDriver.sendTo(request.address, data, request.length);
+		}
+		while (!i2cDriver.isReady())
+			;
+
+		latencies.push_back(i2cSimulatedBus.now() - scheduled);
+		if (i2cDriver.getLastStatus() != request.status) {
+			mismatches++;
+		}
+		if (i2cDriver.getLastStatus() == I2C_OK) {
+			bytes += request.length;
+		}
+	}
+	total = (i2cSimulatedBus.now() - replayStart) / 1000.0;
+
+	std::sort(latencies.begin(), latencies.end());
+	printf("%lu requests, %lu bytes, %lu nacks in %.1f us, %.0f bytes/s\n", (unsigned long) requests.size(),
+			bytes, i2cSimulatedBus.getStatistics().nacks, total, bytes * 1000000.0 / total);
+	printf("latency %.1f us median, %.1f us p99, %.1f us max\n", percentile(latencies, 50),
+			percentile(latencies, 99), percentile(latencies, 100));
+	if (recorded) {
+		printf("%u requests started after their recorded time\n", late);
+	}
+	if (mismatches != 0) {
+		printf("%u requests with a status different from the trace\n", mismatches);
+	}
+
+	return 0;
+}
@@ -0,0 +1,570 @@
+/* ----------------------------------------------------------------------------
+  I2CSimulatedDevices.cpp - Catalog of simulated I2C slave devices
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include "I2CSimulatedDevices.hpp"
+
+/* Commands of the temperature sensor */
+#define SENSOR_MEASURE_HOLD			0xE3
+#define SENSOR_MEASURE_NO_HOLD		0xF3
+#define SENSOR_SOFT_RESET			0xFE
+
+/* Registers of the IMU */
+#define IMU_INT_STATUS				0x3A
+#define IMU_USER_CTRL				0x6A
+#define IMU_FIFO_COUNTH				0x72
+#define IMU_FIFO_COUNTL				0x73
+#define IMU_FIFO_R_W				0x74
+#define IMU_WHO_AM_I				0x75
+#define IMU_FIFO_EN					0x40
+#define IMU_FIFO_RESET				0x04
+#define IMU_FIFO_OFLOW				0x10
+#define IMU_FIFO_SIZE				1024
+#define IMU_SAMPLE_SIZE				12
+
+/* Commands of the battery gauge */
+#define GAUGE_TEMPERATURE			0x08
+#define GAUGE_VOLTAGE				0x09
+#define GAUGE_CURRENT				0x0A
+#define GAUGE_RELATIVE_CHARGE		0x0D
+#define GAUGE_REMAINING_CAPACITY	0x0F
+#define GAUGE_FULL_CAPACITY			0x10
+#define GAUGE_MANUFACTURER_NAME		0x20
+#define GAUGE_DEVICE_NAME			0x21
+
+/* ******************************************************************** */
+/* EEPROM 24Cxx                                                         */
+/* ******************************************************************** */
+
+I2CSimulatedEeprom::I2CSimulatedEeprom(uint8_t address, uint32_t size, uint8_t pageSize, uint8_t addressSize) :
+		I2CSimulatedDevice(address), memory(size, 0xFF), nbWriteCycles(0), pointer(0), block(0),
+		pageSize(pageSize), addressSize(addressSize), nbAddressBytes(0), latch(pageSize),
+		latched(pageSize, 0), latchUsed(0), writeCycle(SIMULATED_MS(5)), busyUntil(0) {
+}
+
+uint8_t I2CSimulatedEeprom::matches(uint8_t address) {
+	uint32_t nbBlocks = addressSize == 1 ? (memory.size() + 255) / 256 : 1;
+
+	return address >= this->address && address < this->address + nbBlocks;
+}
+
+uint8_t I2CSimulatedEeprom::start(uint8_t address, uint8_t read, tSimulatedTime now) {
+	// No answer during the write cycle
+	if (now < busyUntil) {
+		return 0;
+	}
+
+	if (addressSize == 1) {
+		block = address - this->address;
+		pointer = ((block << 8) | (pointer & 0xFF)) % memory.size();
+	}
+	nbAddressBytes = 0;
+	return 1;
+}
+
+uint8_t I2CSimulatedEeprom::write(uint8_t value, tSimulatedTime now) {
+	uint32_t offset;
+
+	if (nbAddressBytes < addressSize) {
+		pointer = nbAddressBytes == 0 ? value : (pointer << 8) | value;
+		if (++nbAddressBytes == addressSize) {
+			if (addressSize == 1) {
+				pointer |= block << 8;
+			}
+			pointer %= memory.size();
+		}
+		return 1;
+	}
+
+	// The address rolls over inside the page
+	offset = pointer % pageSize;
+	latch[offset] = value;
+	latched[offset] = 1;
+	latchUsed = 1;
+	pointer += (offset + 1) % pageSize - offset;
+	return 1;
+}
+
+uint8_t I2CSimulatedEeprom::read(tSimulatedTime now) {
+	uint8_t value = memory[pointer];
+
+	pointer = (pointer + 1) % memory.size();
+	return value;
+}
+
+void I2CSimulatedEeprom::stop(tSimulatedTime now) {
+	uint32_t page = pointer - pointer % pageSize;
+	uint8_t i;
+
+	if (latchUsed) {
+		for (i = 0; i < pageSize; i++) {
+			if (latched[i]) {
+				memory[page + i] = latch[i];
+				latched[i] = 0;
+			}
+		}
+		latchUsed = 0;
+		busyUntil = now + writeCycle;
+		nbWriteCycles++;
+	}
+}
+
+void I2CSimulatedEeprom::setWriteCycle(tSimulatedTime duration) {
+	writeCycle = duration;
+}
+
+/* ******************************************************************** */
+/* Temperature sensor                                                   */
+/* ******************************************************************** */
+
+I2CSimulatedTemperatureSensor::I2CSimulatedTemperatureSensor(uint8_t address) :
+		I2CSimulatedDevice(address), resultIndex(0), converting(0), holdMaster(0),
+		resultAvailable(0), reading(0), temperature(25.0), conversionTime(SIMULATED_MS(50)),
+		conversionEnd(0) {
+}
+
+uint8_t I2CSimulatedTemperatureSensor::start(uint8_t address, uint8_t read, tSimulatedTime now) {
+	if (!read) {
+		return 1;
+	}
+
+	if (converting) {
+		if (now < conversionEnd) {
+			if (!holdMaster) {
+				return 0;
+			}
+			// Hold master: SCL low until the end of the conversion
+			stretchClock(conversionEnd - now);
+		}
+		converting = 0;
+		resultAvailable = 1;
+	}
+
+	if (!resultAvailable) {
+		return 0;
+	}
+	resultIndex = 0;
+	reading = 1;
+	return 1;
+}
+
+uint8_t I2CSimulatedTemperatureSensor::write(uint8_t value, tSimulatedTime now) {
+	uint16_t raw;
+	uint8_t crc = 0;
+	uint8_t i;
+	uint8_t bit;
+
+	switch (value) {
+	case SENSOR_MEASURE_HOLD:
+	case SENSOR_MEASURE_NO_HOLD:
+		raw = (uint16_t) ((temperature + 46.85) * 65536.0 / 175.72) & 0xFFFC;
+		result[0] = raw >> 8;
+		result[1] = raw & 0xFF;
+		for (i = 0; i < 2; i++) {
+			crc ^= result[i];
+			for (bit = 0; bit < 8; bit++) {
+				crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+			}
+		}
+		result[2] = crc;
+		holdMaster = value == SENSOR_MEASURE_HOLD;
+		converting = 1;
+		resultAvailable = 0;
+		conversionEnd = now + conversionTime;
+		return 1;
+
+	case SENSOR_SOFT_RESET:
+		converting = 0;
+		resultAvailable = 0;
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+uint8_t I2CSimulatedTemperatureSensor::read(tSimulatedTime now) {
+	return resultIndex < sizeof(result) ? result[resultIndex++] : 0xFF;
+}
+
+void I2CSimulatedTemperatureSensor::stop(tSimulatedTime now) {
+	// A result is read once
+	if (reading) {
+		reading = 0;
+		resultAvailable = 0;
+	}
+}
+
+void I2CSimulatedTemperatureSensor::setConversionTime(tSimulatedTime duration) {
+	conversionTime = duration;
+}
+
+void I2CSimulatedTemperatureSensor::setTemperature(double temperature) {
+	this->temperature = temperature;
+}
+
+/* ******************************************************************** */
+/* IMU with a FIFO                                                      */
+/* ******************************************************************** */
+
+I2CSimulatedImu::I2CSimulatedImu(uint8_t address) :
+		I2CSimulatedDevice(address), nbLostSamples(0), pointer(0), pointerWritten(0),
+		fifo(IMU_FIFO_SIZE), fifoHead(0), fifoCount(0), sampleNumber(0),
+		samplePeriod(SIMULATED_MS(1)), nextSample(SIMULATED_MS(1)) {
+	uint8_t i;
+
+	for (i = 0; i < sizeof(registers); i++) {
+		registers[i] = 0;
+	}
+	registers[IMU_WHO_AM_I] = 0x68;
+}
+
+/*
+ * Function update
+ * Desc     store the samples of the elapsed periods
+ */
+void I2CSimulatedImu::update(tSimulatedTime now) {
+	unsigned long nbSamples;
+
+	if (now < nextSample) {
+		return;
+	}
+
+	nbSamples = (now - nextSample) / samplePeriod + 1;
+	nextSample += nbSamples * samplePeriod;
+	if (!(registers[IMU_USER_CTRL] & IMU_FIFO_EN)) {
+		sampleNumber += nbSamples;
+		return;
+	}
+	while (nbSamples--) {
+		pushSample();
+	}
+}
+
+/*
+ * Function pushSample
+ * Desc     store a sample in the FIFO, the oldest sample is lost when full
+ */
+void I2CSimulatedImu::pushSample(void) {
+	uint8_t axis;
+
+	if (fifoCount + IMU_SAMPLE_SIZE > IMU_FIFO_SIZE) {
+		fifoHead = (fifoHead + IMU_SAMPLE_SIZE) % IMU_FIFO_SIZE;
+		fifoCount -= IMU_SAMPLE_SIZE;
+		registers[IMU_INT_STATUS] |= IMU_FIFO_OFLOW;
+		nbLostSamples++;
+	}
+
+	for (axis = 0; axis < IMU_SAMPLE_SIZE / 2; axis++) {
+		uint16_t word = (uint16_t) (sampleNumber * 6 + axis);
+
+		fifo[(fifoHead + fifoCount++) % IMU_FIFO_SIZE] = word >> 8;
+		fifo[(fifoHead + fifoCount++) % IMU_FIFO_SIZE] = word & 0xFF;
+	}
+	sampleNumber++;
+}
+
+uint8_t I2CSimulatedImu::start(uint8_t address, uint8_t read, tSimulatedTime now) {
+	update(now);
+	if (!read) {
+		pointerWritten = 0;
+	}
+	return 1;
+}
+
+uint8_t I2CSimulatedImu::write(uint8_t value, tSimulatedTime now) {
+	if (!pointerWritten) {
+		pointer = value & 0x7F;
+		pointerWritten = 1;
+		return 1;
+	}
+
+	if (pointer == IMU_USER_CTRL && (value & IMU_FIFO_RESET)) {
+		fifoHead = 0;
+		fifoCount = 0;
+		value &= ~IMU_FIFO_RESET;
+	}
+	if (pointer != IMU_WHO_AM_I && pointer != IMU_FIFO_COUNTH && pointer != IMU_FIFO_COUNTL) {
+		registers[pointer] = value;
+	}
+	pointer = (pointer + 1) & 0x7F;
+	return 1;
+}
+
+uint8_t I2CSimulatedImu::read(tSimulatedTime now) {
+	uint8_t value;
+
+	switch (pointer) {
+	case IMU_FIFO_R_W:
+		// The register address does not move in the FIFO
+		if (fifoCount == 0) {
+			return 0xFF;
+		}
+		value = fifo[fifoHead];
+		fifoHead = (fifoHead + 1) % IMU_FIFO_SIZE;
+		fifoCount--;
+		return value;
+
+	case IMU_FIFO_COUNTH:
+		value = fifoCount >> 8;
+		break;
+
+	case IMU_FIFO_COUNTL:
+		value = fifoCount & 0xFF;
+		break;
+
+	case IMU_INT_STATUS:
+		value = registers[IMU_INT_STATUS];
+		registers[IMU_INT_STATUS] &= ~IMU_FIFO_OFLOW;
+		break;
+
+	default:
+		value = registers[pointer];
+		break;
+	}
+	pointer = (pointer + 1) & 0x7F;
+	return value;
+}
+
+void I2CSimulatedImu::setSamplePeriod(tSimulatedTime period) {
+	samplePeriod = period;
+	nextSample = period;
+}
+
+/* ******************************************************************** */
+/* Multiplexer TCA9548A                                                 */
+/* ******************************************************************** */
+
+I2CSimulatedMultiplexer::I2CSimulatedMultiplexer(uint8_t address) :
+		I2CSimulatedDevice(address), controlRegister(0) {
+}
+
+I2CSimulatedDevice* I2CSimulatedMultiplexer::findDownstream(uint8_t address) {
+	uint8_t channel;
+	size_t i;
+
+	for (channel = 0; channel < 8; channel++) {
+		if (!(controlRegister & (1 << channel))) {
+			continue;
+		}
+		for (i = 0; i < channels[channel].size(); i++) {
+			I2CSimulatedDevice* device = channels[channel][i];
+
+			if (device->matches(address)) {
+				return device;
+			}
+			device = device->findDownstream(address);
+			if (device) {
+				return device;
+			}
+		}
+	}
+	return 0;
+}
+
+uint8_t I2CSimulatedMultiplexer::start(uint8_t address, uint8_t read, tSimulatedTime now) {
+	return 1;
+}
+
+uint8_t I2CSimulatedMultiplexer::write(uint8_t value, tSimulatedTime now) {
+	controlRegister = value;
+	return 1;
+}
+
+uint8_t I2CSimulatedMultiplexer::read(tSimulatedTime now) {
+	return controlRegister;
+}
+
+void I2CSimulatedMultiplexer::attach(uint8_t channel, I2CSimulatedDevice* device) {
+	channels[channel & 7].push_back(device);
+}
+
+/* ******************************************************************** */
+/* SMBus battery gauge                                                  */
+/* ******************************************************************** */
+
+I2CSimulatedBatteryGauge::I2CSimulatedBatteryGauge(uint8_t address) :
+		I2CSimulatedDevice(address), command(0), nbWritten(0), responseLength(0), responseIndex(0) {
+	uint8_t i;
+
+	for (i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+		words[i] = 0;
+	}
+	words[GAUGE_TEMPERATURE] = 2982;
+	words[GAUGE_VOLTAGE] = 7400;
+	words[GAUGE_CURRENT] = (uint16_t) -500;
+	words[GAUGE_RELATIVE_CHARGE] = 80;
+	words[GAUGE_REMAINING_CAPACITY] = 1600;
+	words[GAUGE_FULL_CAPACITY] = 2000;
+	setClockStretching(0, SIMULATED_US(20));
+}
+
+uint8_t I2CSimulatedBatteryGauge::start(uint8_t address, uint8_t read, tSimulatedTime now) {
+	const char *name = 0;
+
+	if (!read) {
+		nbWritten = 0;
+		return 1;
+	}
+
+	responseIndex = 0;
+	if (command == GAUGE_MANUFACTURER_NAME) {
+		name = "Simulation";
+	} else if (command == GAUGE_DEVICE_NAME) {
+		name = "SBS-2S";
+	}
+
+	if (name) {
+		responseLength = 0;
+		while (name[responseLength] && responseLength < sizeof(response) - 1) {
+			response[responseLength + 1] = name[responseLength];
+			responseLength++;
+		}
+		response[0] = responseLength++;
+	} else if (command < sizeof(words) / sizeof(words[0])) {
+		response[0] = words[command] & 0xFF;
+		response[1] = words[command] >> 8;
+		responseLength = 2;
+	} else {
+		responseLength = 0;
+	}
+	return 1;
+}
+
+uint8_t I2CSimulatedBatteryGauge::write(uint8_t value, tSimulatedTime now) {
+	if (nbWritten == 0) {
+		command = value;
+	} else if (command < sizeof(words) / sizeof(words[0]) && nbWritten <= 2) {
+		// Write word, LSB first
+		if (nbWritten == 1) {
+			words[command] = (words[command] & 0xFF00) | value;
+		} else {
+			words[command] = (words[command] & 0x00FF) | (value << 8);
+		}
+	} else {
+		return 0;
+	}
+	nbWritten++;
+	return 1;
+}
+
+uint8_t I2CSimulatedBatteryGauge::read(tSimulatedTime now) {
+	return responseIndex < responseLength ? response[responseIndex++] : 0xFF;
+}
+
+void I2CSimulatedBatteryGauge::setWord(uint8_t command, uint16_t value) {
+	if (command < sizeof(words) / sizeof(words[0])) {
+		words[command] = value;
+	}
+}
+
+/* ******************************************************************** */
+/* DAC                                                                  */
+/* ******************************************************************** */
+
+I2CSimulatedDac::I2CSimulatedDac(uint8_t address) :
+		I2CSimulatedDevice(address), value(0), highByte(0), nbWritten(0), updates(0), lastUpdate(0),
+		shortest(0), longest(0) {
+}
+
+uint8_t I2CSimulatedDac::start(uint8_t address, uint8_t read, tSimulatedTime now) {
+	nbWritten = 0;
+	return !read;
+}
+
+uint8_t I2CSimulatedDac::write(uint8_t value, tSimulatedTime now) {
+	if ((nbWritten++ & 1) == 0) {
+		highByte = value;
+		return 1;
+	}
+
+	// Fast mode write: power down bits and 12 bits of data
+	this->value = ((highByte & 0x0F) << 8) | value;
+	if (updates > 0) {
+		tSimulatedTime interval = now - lastUpdate;
+
+		if (shortest == 0 || interval < shortest) {
+			shortest = interval;
+		}
+		if (interval > longest) {
+			longest = interval;
+		}
+	}
+	lastUpdate = now;
+	updates++;
+	return 1;
+}
+
+uint8_t I2CSimulatedDac::read(tSimulatedTime now) {
+	return 0xFF;
+}
+
+uint16_t I2CSimulatedDac::output(void) const {
+	return value;
+}
+
+unsigned long I2CSimulatedDac::nbUpdates(void) const {
+	return updates;
+}
+
+void I2CSimulatedDac::takeUpdateIntervals(tSimulatedTime* shortest, tSimulatedTime* longest) {
+	*shortest = this->shortest;
+	*longest = this->longest;
+	this->shortest = 0;
+	this->longest = 0;
+	updates = 0;
+}
+
+/* ******************************************************************** */
+/* ADC                                                                  */
+/* ******************************************************************** */
+
+I2CSimulatedAdc::I2CSimulatedAdc(uint8_t address) :
+		I2CSimulatedDevice(address), conversion(0), nbRead(0), conversions(0) {
+}
+
+uint8_t I2CSimulatedAdc::start(uint8_t address, uint8_t read, tSimulatedTime now) {
+	nbRead = 0;
+	return read;
+}
+
+uint8_t I2CSimulatedAdc::write(uint8_t value, tSimulatedTime now) {
+	return 0;
+}
+
+uint8_t I2CSimulatedAdc::read(tSimulatedTime now) {
+	if ((nbRead++ & 1) == 0) {
+		// A new conversion at the first byte of each pair
+		conversion = (conversion + 1) & 0x0FFF;
+		conversions++;
+		return conversion >> 8;
+	}
+	return conversion & 0xFF;
+}
+
+unsigned long I2CSimulatedAdc::nbConversions(void) const {
+	return conversions;
+}
@@ -0,0 +1,276 @@
+/* ----------------------------------------------------------------------------
+  I2CSimulatedDevices.hpp - Catalog of simulated I2C slave devices
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CSIMULATEDDEVICES_HPP_
+#define I2CSIMULATEDDEVICES_HPP_
+
+#include "I2CSimulation.hpp"
+
+/**
+ * EEPROM 24Cxx.
+ *
+ * The first bytes of a write are the memory address (1 or 2 bytes), the
+ * following bytes are latched in the page and written at the stop
+ * condition. During the write cycle the address is not acknowledged. With
+ * a 1 byte memory address, the upper address bits are the low bits of the
+ * device address (24C04 to 24C16).
+ */
+class I2CSimulatedEeprom: public I2CSimulatedDevice {
+
+public:
+
+	/* Default timing: write cycle of 5 ms */
+	I2CSimulatedEeprom(uint8_t address, uint32_t size, uint8_t pageSize, uint8_t addressSize);
+
+	uint8_t matches(uint8_t address);
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now);
+	uint8_t write(uint8_t value, tSimulatedTime now);
+	uint8_t read(tSimulatedTime now);
+	void stop(tSimulatedTime now);
+
+	/* Duration of the write cycle */
+	void setWriteCycle(tSimulatedTime duration);
+	/* Content of the memory */
+	std::vector<uint8_t> memory;
+	/* Number of page writes */
+	unsigned long nbWriteCycles;
+
+private:
+
+	uint32_t pointer;
+	uint32_t block;
+	uint8_t pageSize;
+	uint8_t addressSize;
+	uint8_t nbAddressBytes;
+	std::vector<uint8_t> latch;
+	std::vector<uint8_t> latched;
+	uint8_t latchUsed;
+	tSimulatedTime writeCycle;
+	tSimulatedTime busyUntil;
+};
+
+/**
+ * Temperature sensor with a conversion time (HTU21D command set).
+ *
+ * 0xE3 starts a conversion with hold master: the read address is
+ * acknowledged and SCL is stretched until the end of the conversion.
+ * 0xF3 starts a conversion without hold master: the read address is not
+ * acknowledged until the end of the conversion. The result is 2 bytes
+ * (MSB first) followed by a CRC-8 (polynomial 0x31).
+ */
+class I2CSimulatedTemperatureSensor: public I2CSimulatedDevice {
+
+public:
+
+	/* Default timing: conversion of 50 ms */
+	I2CSimulatedTemperatureSensor(uint8_t address);
+
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now);
+	uint8_t write(uint8_t value, tSimulatedTime now);
+	uint8_t read(tSimulatedTime now);
+	void stop(tSimulatedTime now);
+
+	/* Duration of a conversion */
+	void setConversionTime(tSimulatedTime duration);
+	/* Measured temperature in degrees Celsius */
+	void setTemperature(double temperature);
+
+private:
+
+	uint8_t result[3];
+	uint8_t resultIndex;
+	uint8_t converting;
+	uint8_t holdMaster;
+	uint8_t resultAvailable;
+	uint8_t reading;
+	double temperature;
+	tSimulatedTime conversionTime;
+	tSimulatedTime conversionEnd;
+};
+
+/**
+ * IMU with a FIFO (MPU-6050 register map).
+ *
+ * The first byte of a write is the register, the following bytes are
+ * written from this register. A read returns the registers from the
+ * register, except FIFO_R_W (0x74) which pops the FIFO. FIFO_EN (bit 6 of
+ * USER_CTRL 0x6A) stores a sample of 12 bytes at each sample period,
+ * FIFO_RESET (bit 2) empties the FIFO. When the FIFO is full the oldest
+ * sample is lost and FIFO_OFLOW (bit 4 of INT_STATUS 0x3A) is set until
+ * INT_STATUS is read. Each word of sample n is n * 6 + axis, MSB first.
+ * The samples of the elapsed periods are stored at the start of a transfer.
+ */
+class I2CSimulatedImu: public I2CSimulatedDevice {
+
+public:
+
+	/* Default timing: sample period of 1 ms, FIFO of 1024 bytes */
+	I2CSimulatedImu(uint8_t address);
+
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now);
+	uint8_t write(uint8_t value, tSimulatedTime now);
+	uint8_t read(tSimulatedTime now);
+
+	/* Period of the samples */
+	void setSamplePeriod(tSimulatedTime period);
+	/* Number of samples lost by overflow */
+	unsigned long nbLostSamples;
+
+private:
+
+	void update(tSimulatedTime now);
+	void pushSample(void);
+
+	uint8_t registers[128];
+	uint8_t pointer;
+	uint8_t pointerWritten;
+	std::vector<uint8_t> fifo;
+	size_t fifoHead;
+	size_t fifoCount;
+	unsigned long sampleNumber;
+	tSimulatedTime samplePeriod;
+	tSimulatedTime nextSample;
+};
+
+/**
+ * I2C multiplexer TCA9548A.
+ *
+ * The control register (1 byte, written and read) enables the downstream
+ * channels, the devices of the enabled channels answer on the bus.
+ */
+class I2CSimulatedMultiplexer: public I2CSimulatedDevice {
+
+public:
+
+	I2CSimulatedMultiplexer(uint8_t address);
+
+	I2CSimulatedDevice* findDownstream(uint8_t address);
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now);
+	uint8_t write(uint8_t value, tSimulatedTime now);
+	uint8_t read(tSimulatedTime now);
+
+	/* Connect a device to a downstream channel (0 to 7) */
+	void attach(uint8_t channel, I2CSimulatedDevice* device);
+
+private:
+
+	std::vector<I2CSimulatedDevice*> channels[8];
+	uint8_t controlRegister;
+};
+
+/**
+ * SMBus battery gauge (Smart Battery Data commands).
+ *
+ * The first byte of a write is the command. A read returns a word (LSB
+ * first) or, for the block commands ManufacturerName (0x20) and DeviceName
+ * (0x21), the length followed by the string. The gauge stretches SCL after
+ * each byte, 20 us by default.
+ */
+class I2CSimulatedBatteryGauge: public I2CSimulatedDevice {
+
+public:
+
+	I2CSimulatedBatteryGauge(uint8_t address);
+
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now);
+	uint8_t write(uint8_t value, tSimulatedTime now);
+	uint8_t read(tSimulatedTime now);
+
+	/* Value of a word command */
+	void setWord(uint8_t command, uint16_t value);
+
+private:
+
+	uint16_t words[0x20];
+	uint8_t command;
+	uint8_t nbWritten;
+	uint8_t response[33];
+	uint8_t responseLength;
+	uint8_t responseIndex;
+};
+
+/**
+ * 12 bits DAC MCP4725, fast mode write.
+ *
+ * Each pair of bytes of a write sets the output, the pairs may follow each
+ * other in the same frame. The time between two updates is measured.
+ */
+class I2CSimulatedDac: public I2CSimulatedDevice {
+
+public:
+
+	I2CSimulatedDac(uint8_t address);
+
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now);
+	uint8_t write(uint8_t value, tSimulatedTime now);
+	uint8_t read(tSimulatedTime now);
+
+	/* Output value */
+	uint16_t output(void) const;
+	/* Number of updates of the output */
+	unsigned long nbUpdates(void) const;
+	/* Shortest and longest time between two updates, then restart the measure */
+	void takeUpdateIntervals(tSimulatedTime* shortest, tSimulatedTime* longest);
+
+private:
+
+	uint16_t value;
+	uint8_t highByte;
+	uint8_t nbWritten;
+	unsigned long updates;
+	tSimulatedTime lastUpdate;
+	tSimulatedTime shortest;
+	tSimulatedTime longest;
+};
+
+/**
+ * 12 bits ADC MCP3221, continuous read.
+ *
+ * Each pair of bytes of a read is a new conversion. The converted value is
+ * a counter incremented at each conversion, a lost sample is a gap.
+ */
+class I2CSimulatedAdc: public I2CSimulatedDevice {
+
+public:
+
+	I2CSimulatedAdc(uint8_t address);
+
+	uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now);
+	uint8_t write(uint8_t value, tSimulatedTime now);
+	uint8_t read(tSimulatedTime now);
+
+	/* Number of conversions */
+	unsigned long nbConversions(void) const;
+
+private:
+
+	uint16_t conversion;
+	uint8_t nbRead;
+	unsigned long conversions;
+};
+
+#endif /* I2CSIMULATEDDEVICES_HPP_ */
@@ -0,0 +1,963 @@
+/* ----------------------------------------------------------------------------
+  I2CSimulation.cpp - Simulated TWI of the ATmega 328P, TWI0 of the megaAVR
+                      0-series and simulated I2C bus
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#include "I2CSimulation.hpp"
+#include "Arduino.h"
+
+/* Bits of TWCR */
+#define CONTROL_TWINT				0x80
+#define CONTROL_TWEA				0x40
+#define CONTROL_TWSTA				0x20
+#define CONTROL_TWSTO				0x10
+#define CONTROL_TWEN				0x04
+#define CONTROL_TWIE				0x01
+
+/* Status of the TWI in TWSR */
+#define STATUS_START				0x08
+#define STATUS_REPEATED_START		0x10
+#define STATUS_SLA_W_ACK			0x18
+#define STATUS_SLA_W_NACK			0x20
+#define STATUS_DATA_SENT_ACK		0x28
+#define STATUS_DATA_SENT_NACK		0x30
+#define STATUS_SLA_R_ACK			0x40
+#define STATUS_SLA_R_NACK			0x48
+#define STATUS_DATA_RECEIVED_ACK	0x50
+#define STATUS_DATA_RECEIVED_NACK	0x58
+
+/* Bits of the TWI0 */
+#define TWI0_RIEN					0x80
+#define TWI0_WIEN					0x40
+#define TWI0_DIEN					0x80
+#define TWI0_APIEN					0x40
+#define TWI0_PIEN					0x20
+#define TWI0_SMEN					0x02
+#define TWI0_ENABLE					0x01
+#define TWI0_ACKACT_NACK			0x04
+#define TWI0_COMMAND				0x03
+#define TWI0_RIF					0x80
+#define TWI0_WIF					0x40
+#define TWI0_DIF					0x80
+#define TWI0_APIF					0x40
+#define TWI0_CLKHOLD				0x20
+#define TWI0_RXACK					0x10
+#define TWI0_ARBLOST				0x08
+#define TWI0_COLL					0x08
+#define TWI0_BUSERR					0x04
+#define TWI0_DIR					0x02
+#define TWI0_AP						0x01
+
+/* Commands of MCTRLB and SCTRLB */
+#define HOST_REPSTART				0x01
+#define HOST_RECVTRANS				0x02
+#define HOST_STOP					0x03
+#define CLIENT_COMPTRANS			0x02
+#define CLIENT_RESPONSE				0x03
+
+/* Bus state of MSTATUS */
+#define BUSSTATE_IDLE				0x01
+#define BUSSTATE_OWNER				0x02
+#define BUSSTATE_BUSY				0x03
+
+/* SCL period of the external master when the host of the TWI0 is disabled */
+#define CLIENT_BIT_TIME				SIMULATED_US(10)
+
+/* Default reaction time of the interruption */
+#define DEFAULT_INTERRUPT_CYCLES	80
+
+/* Bits of the Timer1 registers */
+#define TIMER_WGM12					0x08
+#define TIMER_CLOCK_SELECT			0x07
+#define TIMER_OCIE1A				0x02
+
+/* Interruptions of the TWI or of the TWI0, defined by the driver */
+extern "C" void TWI_vect(void) __attribute__((weak));
+extern "C" void TWI0_TWIM_vect(void) __attribute__((weak));
+extern "C" void TWI0_TWIS_vect(void) __attribute__((weak));
+
+/* Interruption of the Timer1, defined by the driver when it uses the Timer1 */
+extern "C" void TIMER1_COMPA_vect(void) __attribute__((weak));
+
+/** Port of SDA and SCL */
+volatile uint8_t PORTC;
+
+/** Port of SDA and SCL of the megaAVR 0-series */
+PORT_t PORTA;
+
+/** Instantiation of the simulated bus */
+I2CSimulatedBus i2cSimulatedBus;
+
+/* ******************************************************************** */
+/* Slave device                                                         */
+/* ******************************************************************** */
+
+I2CSimulatedDevice::I2CSimulatedDevice(uint8_t address) :
+		address(address), addressStretching(0), byteStretching(0), heldClock(0) {
+}
+
+I2CSimulatedDevice::~I2CSimulatedDevice() {
+}
+
+uint8_t I2CSimulatedDevice::matches(uint8_t address) {
+	return address == this->address;
+}
+
+I2CSimulatedDevice* I2CSimulatedDevice::findDownstream(uint8_t address) {
+	return 0;
+}
+
+void I2CSimulatedDevice::stop(tSimulatedTime now) {
+}
+
+void I2CSimulatedDevice::setClockStretching(tSimulatedTime onAddress, tSimulatedTime onByte) {
+	addressStretching = onAddress;
+	byteStretching = onByte;
+}
+
+tSimulatedTime I2CSimulatedDevice::takeClockStretching(uint8_t onAddress) {
+	tSimulatedTime stretching = heldClock + (onAddress ? addressStretching : byteStretching);
+
+	heldClock = 0;
+	return stretching;
+}
+
+void I2CSimulatedDevice::stretchClock(tSimulatedTime duration) {
+	heldClock += duration;
+}
+
+/* ******************************************************************** */
+/* TWCR                                                                 */
+/* ******************************************************************** */
+
+I2CSimulatedControlRegister& I2CSimulatedControlRegister::operator=(unsigned int value) {
+	i2cSimulatedBus.writeControl(value);
+	return *this;
+}
+
+I2CSimulatedControlRegister& I2CSimulatedControlRegister::operator=(const I2CSimulatedControlRegister& other) {
+	i2cSimulatedBus.writeControl(other);
+	return *this;
+}
+
+I2CSimulatedControlRegister& I2CSimulatedControlRegister::operator&=(unsigned int value) {
+	i2cSimulatedBus.writeControl(i2cSimulatedBus.readControl() & value);
+	return *this;
+}
+
+I2CSimulatedControlRegister& I2CSimulatedControlRegister::operator|=(unsigned int value) {
+	i2cSimulatedBus.writeControl(i2cSimulatedBus.readControl() | value);
+	return *this;
+}
+
+I2CSimulatedControlRegister::operator uint8_t() const {
+	return i2cSimulatedBus.readControl();
+}
+
+/* ******************************************************************** */
+/* Registers of the TWI0                                                */
+/* ******************************************************************** */
+
+I2CSimulatedTwi0Register::I2CSimulatedTwi0Register(tI2CSimulatedTwi0Register index) :
+		index(index) {
+}
+
+I2CSimulatedTwi0Register& I2CSimulatedTwi0Register::operator=(unsigned int value) {
+	i2cSimulatedBus.writeTwi0(index, value);
+	return *this;
+}
+
+I2CSimulatedTwi0Register& I2CSimulatedTwi0Register::operator=(const I2CSimulatedTwi0Register& other) {
+	i2cSimulatedBus.writeTwi0(index, i2cSimulatedBus.readTwi0(other.index));
+	return *this;
+}
+
+I2CSimulatedTwi0Register& I2CSimulatedTwi0Register::operator&=(unsigned int value) {
+	i2cSimulatedBus.writeTwi0(index, i2cSimulatedBus.readTwi0(index) & value);
+	return *this;
+}
+
+I2CSimulatedTwi0Register& I2CSimulatedTwi0Register::operator|=(unsigned int value) {
+	i2cSimulatedBus.writeTwi0(index, i2cSimulatedBus.readTwi0(index) | value);
+	return *this;
+}
+
+I2CSimulatedTwi0Register::operator uint8_t() {
+	return i2cSimulatedBus.readTwi0(index);
+}
+
+I2CSimulatedTwi0::I2CSimulatedTwi0() :
+		MCTRLA(SIMULATED_MCTRLA), MCTRLB(SIMULATED_MCTRLB), MSTATUS(SIMULATED_MSTATUS),
+		MBAUD(SIMULATED_MBAUD), MADDR(SIMULATED_MADDR), MDATA(SIMULATED_MDATA),
+		SCTRLA(SIMULATED_SCTRLA), SCTRLB(SIMULATED_SCTRLB), SSTATUS(SIMULATED_SSTATUS),
+		SADDR(SIMULATED_SADDR), SDATA(SIMULATED_SDATA) {
+}
+
+/* ******************************************************************** */
+/* Bus                                                                  */
+/* ******************************************************************** */
+
+I2CSimulatedBus::I2CSimulatedBus() {
+	setInterruptCycles(DEFAULT_INTERRUPT_CYCLES);
+	reset();
+}
+
+/**
+ * Connect a slave device to the bus.
+ *
+ * device   : device, it must live as long as the bus uses it
+ */
+void I2CSimulatedBus::attach(I2CSimulatedDevice* device) {
+	devices.push_back(device);
+}
+
+/**
+ * Remove all the devices, reset the TWI, the time and the statistics.
+ */
+void I2CSimulatedBus::reset(void) {
+	devices.clear();
+	selected = 0;
+	time = 0;
+	busFree = 0;
+	stopEnd = 0;
+	eventTime = 0;
+	phase = BUS_IDLE;
+	control = 0;
+	interruptFlag = 0;
+	eventPending = 0;
+	eventStatus = 0;
+	receivedByte = 0;
+	busOwned = 0;
+	inInterrupt = 0;
+	twsr = 0;
+	twdr = 0xFF;
+	twar = 0;
+	twbr = 0;
+	twamr = 0;
+	tccr1a = 0;
+	tccr1b = 0;
+	timsk1 = 0;
+	ocr1a = 0;
+	tcnt1 = 0;
+	timerNext = 0;
+	externalTime = 0;
+	externalHandler = 0;
+	for (size_t i = 0; i < SIMULATED_TWI0_REGISTERS; i++) {
+		twi0Registers[i] = 0;
+	}
+	clientAck = 0;
+	clearStatistics();
+}
+
+/**
+ * CPU cycles from TWINT to the write of TWCR in the interruption.
+ */
+void I2CSimulatedBus::setInterruptCycles(unsigned long cycles) {
+	interruptTime = (tSimulatedTime) cycles * 1000000000ULL / F_CPU;
+}
+
+tSimulatedTime I2CSimulatedBus::now(void) const {
+	return time;
+}
+
+/**
+ * Advance the simulated time, the application is waiting.
+ * The interruption of the Timer1 is called at its compare matches.
+ */
+void I2CSimulatedBus::advance(tSimulatedTime duration) {
+	tSimulatedTime end = time + duration;
+	tSimulatedTime period = timerPeriod();
+
+	if (period == 0 || (timsk1 & TIMER_OCIE1A) == 0 || TIMER1_COMPA_vect == 0) {
+		timerNext = 0;
+	} else {
+		if (timerNext == 0) {
+			timerNext = time + period;
+		}
+		while (timerNext <= end) {
+			if (time < timerNext) {
+				time = timerNext;
+			}
+			timerNext += period;
+			statistics.timerInterrupts++;
+			TIMER1_COMPA_vect();
+			// The matches during the transfer started by the interruption set OCF1A
+			// once: the interruption is called one more time, at the end of the transfer
+			if (timerNext <= time) {
+				timerNext += (time - timerNext) / period * period;
+			}
+		}
+	}
+
+	if (externalHandler != 0 && externalTime <= end) {
+		callExternalInterrupt();
+	}
+
+	if (time < end) {
+		time = end;
+	}
+}
+
+/**
+ * Call a handler once at a time, during a transfer or while the application
+ * waits. During a transfer, the handler is called between two events of the
+ * TWI and a transfer it starts is run after the current one.
+ *
+ * at       : simulated time of the interruption
+ * handler  : interruption routine
+ */
+void I2CSimulatedBus::setExternalInterrupt(tSimulatedTime at, void (*handler)(void)) {
+	externalTime = at;
+	externalHandler = handler;
+}
+
+/*
+ * Function callExternalInterrupt
+ * Desc     call the handler of the external interruption at its time
+ */
+void I2CSimulatedBus::callExternalInterrupt(void) {
+	void (*handler)(void) = externalHandler;
+
+	externalHandler = 0;
+	if (time < externalTime) {
+		time = externalTime;
+	}
+	handler();
+}
+
+/*
+ * Function timerPeriod
+ * Desc     period of the compare match of the Timer1 in CTC mode
+ * Output   0 if the timer is stopped
+ */
+tSimulatedTime I2CSimulatedBus::timerPeriod(void) const {
+	static const unsigned long prescalers[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+	unsigned long prescaler = prescalers[tccr1b & TIMER_CLOCK_SELECT];
+
+	if (prescaler == 0 || (tccr1b & TIMER_WGM12) == 0) {
+		return 0;
+	}
+	return ((tSimulatedTime) ocr1a + 1) * prescaler * 1000000000ULL / F_CPU;
+}
+
+const tI2CSimulatedStatistics& I2CSimulatedBus::getStatistics(void) const {
+	return statistics;
+}
+
+void I2CSimulatedBus::clearStatistics(void) {
+	statistics.starts = 0;
+	statistics.bytes = 0;
+	statistics.nacks = 0;
+	statistics.interrupts = 0;
+	statistics.stretching = 0;
+	statistics.timerInterrupts = 0;
+}
+
+/*
+ * Function bitTime
+ * Desc     SCL period given by MBAUD of the TWI0, or by TWBR and the
+ *          prescaler of TWSR
+ */
+tSimulatedTime I2CSimulatedBus::bitTime(void) const {
+	tSimulatedTime prescaler = 1ULL << (2 * (twsr & 0x03));
+
+	if (hostEnabled()) {
+		// The rise time is neglected
+		return (10 + 2 * (tSimulatedTime) twi0Registers[SIMULATED_MBAUD]) * 1000000000ULL / F_CPU;
+	}
+	if (twi0Registers[SIMULATED_SCTRLA] & TWI0_ENABLE) {
+		return CLIENT_BIT_TIME;
+	}
+	return (16 + 2 * twbr * prescaler) * 1000000000ULL / F_CPU;
+}
+
+/*
+ * Function findDevice
+ * Desc     device answering an address, on the bus or behind a multiplexer
+ */
+I2CSimulatedDevice* I2CSimulatedBus::findDevice(uint8_t address) {
+	size_t i;
+
+	for (i = 0; i < devices.size(); i++) {
+		if (devices[i]->matches(address)) {
+			return devices[i];
+		}
+	}
+	for (i = 0; i < devices.size(); i++) {
+		I2CSimulatedDevice* device = devices[i]->findDownstream(address);
+
+		if (device) {
+			return device;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function schedule
+ * Desc     set TWINT with a status at the end of the current action
+ */
+void I2CSimulatedBus::schedule(tSimulatedTime duration, uint8_t status) {
+	eventTime = time + duration;
+	eventStatus = status;
+	eventPending = 1;
+}
+
+/*
+ * Function startCondition
+ * Desc     start or repeated start, the address follows
+ */
+void I2CSimulatedBus::startCondition(void) {
+	statistics.starts++;
+	if (busOwned) {
+		if (selected) {
+			selected->stop(time);
+			selected = 0;
+		}
+		schedule(bitTime(), STATUS_REPEATED_START);
+	} else {
+		busOwned = 1;
+		schedule((busFree > time ? busFree - time : 0) + bitTime(), STATUS_START);
+	}
+	phase = BUS_ADDRESS;
+}
+
+/*
+ * Function stopCondition
+ * Desc     stop condition, a second stop condition is ignored
+ */
+void I2CSimulatedBus::stopCondition(void) {
+	if (busOwned) {
+		if (selected) {
+			selected->stop(time);
+			selected = 0;
+		}
+		busOwned = 0;
+		phase = BUS_IDLE;
+		interruptFlag = 0;
+		stopEnd = time + bitTime();
+		busFree = stopEnd + bitTime();
+	}
+}
+
+/*
+ * Function transfer
+ * Desc     address or byte sent, or byte received, in the current phase
+ * Input    value : address or byte sent
+ *          ack   : acknowledge of the master after a received byte
+ */
+void I2CSimulatedBus::transfer(uint8_t value, uint8_t ack) {
+	tSimulatedTime stretching = 0;
+	uint8_t status = 0;
+	uint8_t master = ack;
+
+	statistics.bytes++;
+	switch (phase) {
+	case BUS_ADDRESS: {
+		uint8_t read = value & 1;
+		I2CSimulatedDevice* device = findDevice(value >> 1);
+
+		ack = device && device->start(value >> 1, read, time);
+		if (ack) {
+			selected = device;
+			stretching = device->takeClockStretching(1);
+			phase = read ? BUS_RECEIVE : BUS_TRANSMIT;
+		}
+		if (read) {
+			status = ack ? STATUS_SLA_R_ACK : STATUS_SLA_R_NACK;
+		} else {
+			status = ack ? STATUS_SLA_W_ACK : STATUS_SLA_W_NACK;
+		}
+		break;
+	}
+
+	case BUS_TRANSMIT:
+		ack = selected->write(value, time);
+		stretching = selected->takeClockStretching(0);
+		status = ack ? STATUS_DATA_SENT_ACK : STATUS_DATA_SENT_NACK;
+		break;
+
+	case BUS_RECEIVE:
+		// The acknowledge is sent by the master
+		ack = 1;
+		receivedByte = selected->read(time);
+		stretching = selected->takeClockStretching(0);
+		status = master ? STATUS_DATA_RECEIVED_ACK : STATUS_DATA_RECEIVED_NACK;
+		break;
+
+	default:
+		ack = 0;
+		break;
+	}
+
+	if (!ack) {
+		statistics.nacks++;
+	}
+	statistics.stretching += stretching;
+	schedule(9 * bitTime() + stretching, status);
+}
+
+/**
+ * Write of TWCR.
+ *
+ * value    : written value
+ */
+void I2CSimulatedBus::writeControl(uint8_t value) {
+	uint8_t command = (value & CONTROL_TWINT) && interruptFlag;
+
+	control = value & (CONTROL_TWEA | CONTROL_TWEN | CONTROL_TWIE);
+
+	if (!(value & CONTROL_TWEN)) {
+		// TWI disabled, the current transfer is lost
+		eventPending = 0;
+		interruptFlag = 0;
+		busOwned = 0;
+		selected = 0;
+		phase = BUS_IDLE;
+		return;
+	}
+
+	if (value & CONTROL_TWSTO) {
+		stopCondition();
+	}
+	if (value & CONTROL_TWSTA) {
+		// With TWSTO, the start condition follows the stop condition
+		interruptFlag = 0;
+		startCondition();
+	} else if (command && !(value & CONTROL_TWSTO)) {
+		interruptFlag = 0;
+		transfer(twdr, value & CONTROL_TWEA);
+	}
+
+	run();
+}
+
+/**
+ * Read of TWCR.
+ */
+uint8_t I2CSimulatedBus::readControl(void) const {
+	return control | (interruptFlag ? CONTROL_TWINT : 0) | (time < stopEnd ? CONTROL_TWSTO : 0);
+}
+
+/*
+ * Function run
+ * Desc     run the transfer started by the application to its end
+ */
+void I2CSimulatedBus::run(void) {
+	if (inInterrupt) {
+		return;
+	}
+
+	while (eventPending) {
+		if (externalHandler != 0 && externalTime <= eventTime) {
+			inInterrupt = 1;
+			callExternalInterrupt();
+			inInterrupt = 0;
+		}
+		if (time < eventTime) {
+			time = eventTime;
+		}
+		eventPending = 0;
+
+		if (hostEnabled()) {
+			if (!setHostStatus(eventStatus)) {
+				continue;
+			}
+		} else {
+			twsr = (twsr & 0x07) | eventStatus;
+			if (eventStatus == STATUS_DATA_RECEIVED_ACK || eventStatus == STATUS_DATA_RECEIVED_NACK) {
+				twdr = receivedByte;
+			}
+			interruptFlag = 1;
+
+			if ((control & CONTROL_TWIE) == 0) {
+				break;
+			}
+		}
+		// SCL is held low until the interruption writes TWCR, MCTRLB or MDATA
+		time += interruptTime;
+		statistics.interrupts++;
+		inInterrupt = 1;
+		if (hostEnabled()) {
+			TWI0_TWIM_vect();
+		} else {
+			TWI_vect();
+		}
+		inInterrupt = 0;
+	}
+
+	// The stop condition ends the transfer
+	if (time < stopEnd) {
+		time = stopEnd;
+	}
+}
+
+/* ******************************************************************** */
+/* TWI0                                                                 */
+/* ******************************************************************** */
+
+/*
+ * Function hostEnabled
+ * Desc     check if the host of the TWI0 replaces the TWI
+ */
+uint8_t I2CSimulatedBus::hostEnabled(void) const {
+	return (twi0Registers[SIMULATED_MCTRLA] & TWI0_ENABLE) != 0;
+}
+
+/*
+ * Function setHostStatus
+ * Desc     set the flags of MSTATUS at the end of an action of the host
+ * Input    status : status of the action, as in TWSR
+ * Output   1 if TWI0_TWIM_vect is called, 0 if the host goes on alone
+ */
+uint8_t I2CSimulatedBus::setHostStatus(uint8_t status) {
+	uint8_t flags;
+
+	switch (status) {
+	case STATUS_START:
+	case STATUS_REPEATED_START:
+		// MADDR is sent after the start condition
+		transfer(twi0Registers[SIMULATED_MADDR], 0);
+		return 0;
+
+	case STATUS_SLA_R_ACK:
+		// The first byte is received after the address
+		transfer(0xFF, 1);
+		return 0;
+
+	case STATUS_DATA_RECEIVED_ACK:
+	case STATUS_DATA_RECEIVED_NACK:
+		twi0Registers[SIMULATED_MDATA] = receivedByte;
+		flags = TWI0_RIF;
+		break;
+
+	case STATUS_SLA_W_ACK:
+	case STATUS_DATA_SENT_ACK:
+		flags = TWI0_WIF;
+		break;
+
+	default:
+		// Address or byte not acknowledged
+		flags = TWI0_WIF | TWI0_RXACK;
+		break;
+	}
+
+	twi0Registers[SIMULATED_MSTATUS] = (twi0Registers[SIMULATED_MSTATUS] & ~TWI0_RXACK) | flags | TWI0_CLKHOLD;
+	return (twi0Registers[SIMULATED_MCTRLA] & (flags & TWI0_RIF ? TWI0_RIEN : TWI0_WIEN)) != 0;
+}
+
+/*
+ * Function hostCommand
+ * Desc     command of MCTRLB, or acknowledge action of a read of MDATA in
+ *          smart mode
+ */
+void I2CSimulatedBus::hostCommand(uint8_t command) {
+	if (command == 0) {
+		return;
+	}
+
+	twi0Registers[SIMULATED_MSTATUS] &= ~(TWI0_RIF | TWI0_WIF | TWI0_CLKHOLD);
+	switch (command) {
+	case HOST_REPSTART:
+		startCondition();
+		break;
+
+	case HOST_RECVTRANS:
+		// After a NACK, the host waits for a start or a stop condition
+		if (phase == BUS_RECEIVE && !(twi0Registers[SIMULATED_MCTRLB] & TWI0_ACKACT_NACK)) {
+			transfer(0xFF, 1);
+		}
+		break;
+
+	case HOST_STOP:
+		stopCondition();
+		break;
+	}
+	run();
+}
+
+/*
+ * Function clientCommand
+ * Desc     command of SCTRLB, or response of a read or a write of SDATA in
+ *          smart mode
+ */
+void I2CSimulatedBus::clientCommand(uint8_t command) {
+	if (command == CLIENT_RESPONSE) {
+		clientAck = !(twi0Registers[SIMULATED_SCTRLB] & TWI0_ACKACT_NACK);
+	} else if (command == CLIENT_COMPTRANS) {
+		clientAck = 0;
+	} else {
+		return;
+	}
+	twi0Registers[SIMULATED_SSTATUS] &= ~(TWI0_DIF | TWI0_APIF | TWI0_CLKHOLD);
+}
+
+/**
+ * Write of a register of the TWI0.
+ *
+ * index    : register
+ * value    : written value
+ */
+void I2CSimulatedBus::writeTwi0(tI2CSimulatedTwi0Register index, uint8_t value) {
+	switch (index) {
+	case SIMULATED_MCTRLA:
+		twi0Registers[index] = value;
+		if (!(value & TWI0_ENABLE)) {
+			// Host disabled, the current transfer is lost
+			eventPending = 0;
+			busOwned = 0;
+			selected = 0;
+			phase = BUS_IDLE;
+			twi0Registers[SIMULATED_MSTATUS] = 0;
+		}
+		break;
+
+	case SIMULATED_MCTRLB:
+		twi0Registers[index] = value & TWI0_ACKACT_NACK;
+		hostCommand(value & TWI0_COMMAND);
+		break;
+
+	case SIMULATED_MSTATUS:
+		// The flags are cleared by writing one, the bus state follows the bus
+		twi0Registers[index] &= ~(value & (TWI0_RIF | TWI0_WIF | TWI0_ARBLOST | TWI0_BUSERR));
+		break;
+
+	case SIMULATED_MADDR:
+		twi0Registers[index] = value;
+		if (hostEnabled()) {
+			twi0Registers[SIMULATED_MSTATUS] &= ~(TWI0_RIF | TWI0_WIF | TWI0_CLKHOLD | TWI0_RXACK);
+			startCondition();
+			run();
+		}
+		break;
+
+	case SIMULATED_MDATA:
+		twi0Registers[index] = value;
+		if (phase == BUS_TRANSMIT && (twi0Registers[SIMULATED_MSTATUS] & TWI0_CLKHOLD)) {
+			twi0Registers[SIMULATED_MSTATUS] &= ~(TWI0_WIF | TWI0_CLKHOLD);
+			transfer(value, 0);
+			run();
+		}
+		break;
+
+	case SIMULATED_SCTRLB:
+		twi0Registers[index] = value & TWI0_ACKACT_NACK;
+		clientCommand(value & TWI0_COMMAND);
+		break;
+
+	case SIMULATED_SSTATUS:
+		twi0Registers[index] &= ~(value & (TWI0_DIF | TWI0_APIF | TWI0_COLL | TWI0_BUSERR));
+		break;
+
+	case SIMULATED_SDATA:
+		twi0Registers[index] = value;
+		if (twi0Registers[SIMULATED_SCTRLA] & TWI0_SMEN) {
+			clientCommand(CLIENT_RESPONSE);
+		}
+		break;
+
+	default:
+		twi0Registers[index] = value;
+		break;
+	}
+}
+
+/**
+ * Read of a register of the TWI0.
+ *
+ * index    : register
+ */
+uint8_t I2CSimulatedBus::readTwi0(tI2CSimulatedTwi0Register index) {
+	uint8_t value = twi0Registers[index];
+
+	switch (index) {
+	case SIMULATED_MSTATUS:
+		if (hostEnabled()) {
+			value |= busOwned ? BUSSTATE_OWNER : (time < busFree ? BUSSTATE_BUSY : BUSSTATE_IDLE);
+		}
+		break;
+
+	case SIMULATED_MDATA:
+		// Smart mode: the acknowledge action follows the read of the byte
+		if ((twi0Registers[SIMULATED_MCTRLA] & TWI0_SMEN) && (twi0Registers[SIMULATED_MSTATUS] & TWI0_RIF)) {
+			hostCommand(HOST_RECVTRANS);
+		}
+		break;
+
+	case SIMULATED_SDATA:
+		if (twi0Registers[SIMULATED_SCTRLA] & TWI0_SMEN) {
+			clientCommand(CLIENT_RESPONSE);
+		}
+		break;
+
+	default:
+		break;
+	}
+	return value;
+}
+
+/*
+ * Function clientInterrupt
+ * Desc     set the flags of SSTATUS and call the interruption of the client
+ * Input    status : flags of SSTATUS
+ * Output   1 if the client acknowledges, 0 otherwise
+ */
+uint8_t I2CSimulatedBus::clientInterrupt(uint8_t status) {
+	uint8_t enable = status & TWI0_DIF ? TWI0_DIEN : (status & TWI0_AP ? TWI0_APIEN : TWI0_PIEN);
+
+	twi0Registers[SIMULATED_SSTATUS] = status | TWI0_CLKHOLD;
+	clientAck = 0;
+	if (TWI0_TWIS_vect != 0 && (twi0Registers[SIMULATED_SCTRLA] & enable)) {
+		// SCL is held low until the response of the client
+		time += interruptTime;
+		statistics.interrupts++;
+		inInterrupt = 1;
+		TWI0_TWIS_vect();
+		inInterrupt = 0;
+	}
+	twi0Registers[SIMULATED_SSTATUS] &= ~TWI0_CLKHOLD;
+	return clientAck;
+}
+
+/*
+ * Function clientAddress
+ * Desc     start condition and address of the external master
+ * Output   1 if the client acknowledges, 0 otherwise
+ */
+uint8_t I2CSimulatedBus::clientAddress(uint8_t address, uint8_t read) {
+	if (time < busFree) {
+		time = busFree;
+	}
+	statistics.starts++;
+	statistics.bytes++;
+	time += 10 * bitTime();
+
+	if ((twi0Registers[SIMULATED_SCTRLA] & TWI0_ENABLE) && address == twi0Registers[SIMULATED_SADDR] >> 1
+			&& clientInterrupt(TWI0_APIF | TWI0_AP | (read ? TWI0_DIR : 0))) {
+		return 1;
+	}
+
+	statistics.nacks++;
+	time += bitTime();
+	busFree = time + bitTime();
+	return 0;
+}
+
+/*
+ * Function clientStop
+ * Desc     stop condition of the external master
+ */
+void I2CSimulatedBus::clientStop(void) {
+	time += bitTime();
+	busFree = time + bitTime();
+	clientInterrupt(TWI0_APIF);
+
+	// A transfer of the host started by the client is run after the stop
+	run();
+}
+
+/**
+ * Write of an external master to the client of the TWI0, while the host is
+ * idle.
+ *
+ * address  : address of the client
+ * data     : data to write
+ * length   : number of bytes to write
+ * return   : number of bytes acknowledged, -1 if the host owns the bus or
+ *            if the address is not acknowledged
+ */
+int I2CSimulatedBus::clientWrite(uint8_t address, const uint8_t* data, uint8_t length) {
+	int written = 0;
+
+	if (busOwned || !clientAddress(address, 0)) {
+		return -1;
+	}
+
+	while (written < length) {
+		twi0Registers[SIMULATED_SDATA] = data[written];
+		time += 9 * bitTime();
+		statistics.bytes++;
+		if (!clientInterrupt(TWI0_DIF)) {
+			statistics.nacks++;
+			break;
+		}
+		written++;
+	}
+
+	clientStop();
+	return written;
+}
+
+/**
+ * Read of an external master from the client of the TWI0, while the host is
+ * idle. The master acknowledges all the bytes but the last one.
+ *
+ * address  : address of the client
+ * data     : read data
+ * length   : number of bytes to read
+ * return   : number of bytes read, -1 if the host owns the bus or if the
+ *            address is not acknowledged
+ */
+int I2CSimulatedBus::clientRead(uint8_t address, uint8_t* data, uint8_t length) {
+	uint8_t i;
+
+	if (busOwned || !clientAddress(address, 1)) {
+		return -1;
+	}
+
+	for (i = 0; i < length; i++) {
+		// The client writes SDATA in its interruption
+		clientInterrupt(TWI0_DIF | TWI0_DIR);
+		data[i] = twi0Registers[SIMULATED_SDATA];
+		time += 9 * bitTime();
+		statistics.bytes++;
+	}
+	// The last byte is not acknowledged
+	clientInterrupt(TWI0_DIF | TWI0_DIR | TWI0_RXACK);
+
+	clientStop();
+	return length;
+}
+
+/* ******************************************************************** */
+/* Time functions of the Arduino core                                   */
+/* ******************************************************************** */
+
+unsigned long micros(void) {
+	return (unsigned long) (i2cSimulatedBus.now() / 1000ULL);
+}
+
+unsigned long millis(void) {
+	return (unsigned long) (i2cSimulatedBus.now() / 1000000ULL);
+}
+
+void delay(unsigned long ms) {
+	i2cSimulatedBus.advance(SIMULATED_MS(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+	i2cSimulatedBus.advance(SIMULATED_US(us));
+}
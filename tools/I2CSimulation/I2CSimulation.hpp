@@ -0,0 +1,317 @@
+/* ----------------------------------------------------------------------------
+  I2CSimulation.hpp - Simulated TWI of the ATmega 328P, TWI0 of the megaAVR
+                      0-series and simulated I2C bus
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CSIMULATION_HPP_
+#define I2CSIMULATION_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#ifndef F_CPU
+#define F_CPU						16000000L
+#endif
+
+/** Simulated time in nanoseconds */
+typedef unsigned long long tSimulatedTime;
+
+/** Conversion to the simulated time */
+#define SIMULATED_US(us)			((tSimulatedTime) (us) * 1000ULL)
+#define SIMULATED_MS(ms)			((tSimulatedTime) (ms) * 1000000ULL)
+
+/**
+ * Slave device on the simulated bus.
+ *
+ * The bus calls start() when the device address is sent, then write() or
+ * read() for each byte and stop() at the stop condition. A device holds SCL
+ * low after the acknowledge of the address or of a byte with the clock
+ * stretching of setClockStretching() and stretchClock().
+ */
+class I2CSimulatedDevice {
+
+public:
+
+	I2CSimulatedDevice(uint8_t address);
+	virtual ~I2CSimulatedDevice();
+
+	/* Check if the device answers an address */
+	virtual uint8_t matches(uint8_t address);
+	/* Device of a downstream bus (multiplexer) answering an address */
+	virtual I2CSimulatedDevice* findDownstream(uint8_t address);
+	/* Address received, return 1 for ACK */
+	virtual uint8_t start(uint8_t address, uint8_t read, tSimulatedTime now) = 0;
+	/* Byte written by the master, return 1 for ACK */
+	virtual uint8_t write(uint8_t value, tSimulatedTime now) = 0;
+	/* Byte read by the master */
+	virtual uint8_t read(tSimulatedTime now) = 0;
+	/* Stop condition or repeated start */
+	virtual void stop(tSimulatedTime now);
+
+	/* Clock stretching after the address and after each byte */
+	void setClockStretching(tSimulatedTime onAddress, tSimulatedTime onByte);
+	/* Clock stretching of the last address or byte, used by the bus */
+	tSimulatedTime takeClockStretching(uint8_t onAddress);
+
+protected:
+
+	/* Hold SCL low after the current address or byte */
+	void stretchClock(tSimulatedTime duration);
+
+	uint8_t address;
+
+private:
+
+	tSimulatedTime addressStretching;
+	tSimulatedTime byteStretching;
+	tSimulatedTime heldClock;
+};
+
+/**
+ * TWCR of the simulated TWI: a write with TWINT, TWSTA or TWSTO starts an
+ * action of the TWI.
+ */
+class I2CSimulatedControlRegister {
+
+public:
+
+	I2CSimulatedControlRegister& operator=(unsigned int value);
+	I2CSimulatedControlRegister& operator=(const I2CSimulatedControlRegister& other);
+	I2CSimulatedControlRegister& operator&=(unsigned int value);
+	I2CSimulatedControlRegister& operator|=(unsigned int value);
+	operator uint8_t() const;
+};
+
+/**
+ * Index of the registers of the simulated TWI0
+ */
+typedef enum {
+	SIMULATED_MCTRLA,
+	SIMULATED_MCTRLB,
+	SIMULATED_MSTATUS,
+	SIMULATED_MBAUD,
+	SIMULATED_MADDR,
+	SIMULATED_MDATA,
+	SIMULATED_SCTRLA,
+	SIMULATED_SCTRLB,
+	SIMULATED_SSTATUS,
+	SIMULATED_SADDR,
+	SIMULATED_SDATA,
+	SIMULATED_TWI0_REGISTERS
+} tI2CSimulatedTwi0Register;
+
+/**
+ * Register of the simulated TWI0: a write of MCTRLB, MADDR, MDATA, SCTRLB or
+ * SDATA, and a read of MDATA or SDATA in smart mode, starts an action of the
+ * host or of the client.
+ */
+class I2CSimulatedTwi0Register {
+
+public:
+
+	explicit I2CSimulatedTwi0Register(tI2CSimulatedTwi0Register index);
+
+	I2CSimulatedTwi0Register& operator=(unsigned int value);
+	I2CSimulatedTwi0Register& operator=(const I2CSimulatedTwi0Register& other);
+	I2CSimulatedTwi0Register& operator&=(unsigned int value);
+	I2CSimulatedTwi0Register& operator|=(unsigned int value);
+	operator uint8_t();
+
+private:
+
+	tI2CSimulatedTwi0Register index;
+};
+
+/**
+ * Registers of the TWI0 used by the driver, named as in the megaAVR headers
+ */
+class I2CSimulatedTwi0 {
+
+public:
+
+	I2CSimulatedTwi0();
+
+	I2CSimulatedTwi0Register MCTRLA;
+	I2CSimulatedTwi0Register MCTRLB;
+	I2CSimulatedTwi0Register MSTATUS;
+	I2CSimulatedTwi0Register MBAUD;
+	I2CSimulatedTwi0Register MADDR;
+	I2CSimulatedTwi0Register MDATA;
+	I2CSimulatedTwi0Register SCTRLA;
+	I2CSimulatedTwi0Register SCTRLB;
+	I2CSimulatedTwi0Register SSTATUS;
+	I2CSimulatedTwi0Register SADDR;
+	I2CSimulatedTwi0Register SDATA;
+};
+
+/**
+ * Statistics of the simulated bus
+ */
+typedef struct {
+	unsigned long starts;
+	unsigned long bytes;
+	/* Addresses and bytes not acknowledged by the slaves */
+	unsigned long nacks;
+	unsigned long interrupts;
+	tSimulatedTime stretching;
+	unsigned long timerInterrupts;
+} tI2CSimulatedStatistics;
+
+/**
+ * Simulated TWI of the master and bus with its slave devices.
+ *
+ * The driver uses the TWI (TWCR) or the TWI0: the TWI0 replaces the TWI when
+ * its host is enabled. The host of the TWI0 sends MADDR after the start
+ * condition and receives the first byte after the address of a read, and in
+ * smart mode the read of MDATA sends ACKACT and receives the next byte, so
+ * TWI0_TWIM_vect is only called with RIF or WIF. The client of the TWI0 is
+ * addressed by an external master (clientWrite, clientRead) while the host
+ * is idle, TWI0_TWIS_vect being called for the address, each byte and the
+ * stop condition; the arbitration between two masters is not simulated.
+ *
+ * The application code takes no simulated time: a transfer started by the
+ * application is run to its end before the write of TWCR returns, the
+ * interruption TWI_vect being called for each event of the TWI. The time of
+ * a transfer is the time of the bits at the SCL frequency given by TWBR,
+ * the clock stretching of the slaves and the time of the interruptions,
+ * during which the TWI holds SCL low.
+ * The Timer1 in CTC mode calls TIMER1_COMPA_vect at each compare match
+ * while the application waits (advance, delay). The compare matches during a
+ * transfer started by TIMER1_COMPA_vect are delivered once, at the end of the
+ * transfer.
+ * An external interruption (setExternalInterrupt) is called at its time,
+ * between two events of the TWI during a transfer, to start a request while
+ * the application is blocked.
+ */
+class I2CSimulatedBus {
+
+public:
+
+	I2CSimulatedBus();
+
+	/* Connect a slave device to the bus */
+	void attach(I2CSimulatedDevice* device);
+	/* Remove all the devices and reset the time and the statistics */
+	void reset(void);
+	/* CPU cycles from TWINT to the write of TWCR in the interruption */
+	void setInterruptCycles(unsigned long cycles);
+
+	/* Simulated time */
+	tSimulatedTime now(void) const;
+	/* Advance the simulated time (application waiting) */
+	void advance(tSimulatedTime duration);
+	/* Call a handler once at a time, as the interruption of a pin */
+	void setExternalInterrupt(tSimulatedTime at, void (*handler)(void));
+
+	/* Statistics of the bus */
+	const tI2CSimulatedStatistics& getStatistics(void) const;
+	void clearStatistics(void);
+
+	/* Registers of the TWI */
+	I2CSimulatedControlRegister twcr;
+	uint8_t twsr;
+	uint8_t twdr;
+	uint8_t twar;
+	uint8_t twbr;
+	uint8_t twamr;
+
+	/* Registers of the Timer1 */
+	uint8_t tccr1a;
+	uint8_t tccr1b;
+	uint8_t timsk1;
+	uint16_t ocr1a;
+	uint16_t tcnt1;
+
+	/* Used by I2CSimulatedControlRegister */
+	void writeControl(uint8_t value);
+	uint8_t readControl(void) const;
+
+	/* Registers of the TWI0 */
+	I2CSimulatedTwi0 twi0;
+
+	/* Used by I2CSimulatedTwi0Register */
+	void writeTwi0(tI2CSimulatedTwi0Register index, uint8_t value);
+	uint8_t readTwi0(tI2CSimulatedTwi0Register index);
+
+	/* External master writing to the client of the TWI0 */
+	int clientWrite(uint8_t address, const uint8_t* data, uint8_t length);
+	/* External master reading from the client of the TWI0 */
+	int clientRead(uint8_t address, uint8_t* data, uint8_t length);
+
+private:
+
+	typedef enum {
+		BUS_IDLE,
+		BUS_ADDRESS,
+		BUS_TRANSMIT,
+		BUS_RECEIVE
+	} tSimulatedBusPhase;
+
+	tSimulatedTime bitTime(void) const;
+	tSimulatedTime timerPeriod(void) const;
+	I2CSimulatedDevice* findDevice(uint8_t address);
+	void schedule(tSimulatedTime duration, uint8_t status);
+	void startCondition(void);
+	void stopCondition(void);
+	void transfer(uint8_t value, uint8_t ack);
+	void run(void);
+	void callExternalInterrupt(void);
+	uint8_t hostEnabled(void) const;
+	uint8_t setHostStatus(uint8_t status);
+	void hostCommand(uint8_t command);
+	void clientCommand(uint8_t command);
+	uint8_t clientInterrupt(uint8_t status);
+	uint8_t clientAddress(uint8_t address, uint8_t read);
+	void clientStop(void);
+
+	std::vector<I2CSimulatedDevice*> devices;
+	I2CSimulatedDevice* selected;
+	tI2CSimulatedStatistics statistics;
+	tSimulatedTime time;
+	tSimulatedTime busFree;
+	tSimulatedTime stopEnd;
+	tSimulatedTime eventTime;
+	tSimulatedTime interruptTime;
+	tSimulatedTime timerNext;
+	tSimulatedTime externalTime;
+	void (*externalHandler)(void);
+	tSimulatedBusPhase phase;
+	uint8_t control;
+	uint8_t interruptFlag;
+	uint8_t eventPending;
+	uint8_t eventStatus;
+	uint8_t receivedByte;
+	uint8_t busOwned;
+	uint8_t inInterrupt;
+	uint8_t twi0Registers[SIMULATED_TWI0_REGISTERS];
+	uint8_t clientAck;
+};
+
+/** Instantiation of the simulated bus */
+extern I2CSimulatedBus i2cSimulatedBus;
+
+#endif /* I2CSIMULATION_HPP_ */
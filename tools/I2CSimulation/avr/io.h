@@ -0,0 +1,123 @@
+/* ----------------------------------------------------------------------------
+  avr/io.h - Registers of the ATmega 328P and of the megaAVR 0-series used by
+               the I2C driver, mapped on the simulated TWI and TWI0
+  -----------------------------------------------------------------------------
+  Supported processor: host computer (C++11)
+  -----------------------------------------------------------------------------
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  -----------------------------------------------------------------------------
+
+  EVOLUTIONS:
+  CREATED:   October 18, 2026
+
+---------------------------------------------------------------------------- */
+
+#ifndef I2CSIMULATION_AVR_IO_H_
+#define I2CSIMULATION_AVR_IO_H_
+
+#include <stdint.h>
+#include "../I2CSimulation.hpp"
+
+#define _BV(bit)	(1u << (bit))
+
+/* TWI registers, TWCR starts the actions of the simulated TWI */
+#define TWCR		i2cSimulatedBus.twcr
+#define TWSR		i2cSimulatedBus.twsr
+#define TWDR		i2cSimulatedBus.twdr
+#define TWAR		i2cSimulatedBus.twar
+#define TWBR		i2cSimulatedBus.twbr
+#define TWAMR		i2cSimulatedBus.twamr
+
+/* Bits of TWCR */
+#define TWINT		7
+#define TWEA		6
+#define TWSTA		5
+#define TWSTO		4
+#define TWWC		3
+#define TWEN		2
+#define TWIE		0
+
+/* Bits of TWAR */
+#define TWGCE		0
+
+/* Timer1 registers, the compare match A is simulated in CTC mode */
+#define TCCR1A		i2cSimulatedBus.tccr1a
+#define TCCR1B		i2cSimulatedBus.tccr1b
+#define TIMSK1		i2cSimulatedBus.timsk1
+#define OCR1A		i2cSimulatedBus.ocr1a
+#define TCNT1		i2cSimulatedBus.tcnt1
+
+/* Bits of TCCR1B and TIMSK1 */
+#define WGM12		3
+#define CS10		0
+#define CS11		1
+#define CS12		2
+#define OCIE1A		1
+
+/* Port of SDA and SCL */
+extern volatile uint8_t PORTC;
+#define PC4			4
+#define PC5			5
+
+/* TWI0 of the megaAVR 0-series, the access to its registers starts the
+ * actions of the simulated TWI0 */
+#define TWI0		i2cSimulatedBus.twi0
+
+/* Bits of MCTRLA and SCTRLA */
+#define TWI_RIEN_bm				0x80
+#define TWI_WIEN_bm				0x40
+#define TWI_DIEN_bm				0x80
+#define TWI_APIEN_bm			0x40
+#define TWI_PIEN_bm				0x20
+#define TWI_SMEN_bm				0x02
+#define TWI_ENABLE_bm			0x01
+
+/* Groups of MCTRLB and SCTRLB */
+#define TWI_ACKACT_ACK_gc		0x00
+#define TWI_ACKACT_NACK_gc		0x04
+#define TWI_MCMD_NOACT_gc		0x00
+#define TWI_MCMD_REPSTART_gc	0x01
+#define TWI_MCMD_RECVTRANS_gc	0x02
+#define TWI_MCMD_STOP_gc		0x03
+#define TWI_SCMD_NOACT_gc		0x00
+#define TWI_SCMD_COMPTRANS_gc	0x02
+#define TWI_SCMD_RESPONSE_gc	0x03
+
+/* Bits of MSTATUS and SSTATUS */
+#define TWI_RIF_bm				0x80
+#define TWI_WIF_bm				0x40
+#define TWI_DIF_bm				0x80
+#define TWI_APIF_bm				0x40
+#define TWI_CLKHOLD_bm			0x20
+#define TWI_RXACK_bm			0x10
+#define TWI_ARBLOST_bm			0x08
+#define TWI_COLL_bm				0x08
+#define TWI_BUSERR_bm			0x04
+#define TWI_DIR_bm				0x02
+#define TWI_AP_bm				0x01
+#define TWI_BUSSTATE_IDLE_gc	0x01
+
+/* Port of SDA (PA2) and SCL (PA3) */
+typedef struct {
+	volatile uint8_t PIN2CTRL;
+	volatile uint8_t PIN3CTRL;
+} PORT_t;
+
+extern PORT_t PORTA;
+#define PORT_PULLUPEN_bm		0x08
+
+#endif /* I2CSIMULATION_AVR_IO_H_ */